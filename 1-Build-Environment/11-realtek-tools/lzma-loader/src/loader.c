@@ -24,6 +24,20 @@
 #include "printf.h"
 #include "LzmaDecode.h"
 
+/*
+ * Boot timestamps (see realtek_boottimes.h in the kernel tree, found via
+ * KERNEL_DIR). Without it the marks compile to nothing.
+ */
+#if defined(__has_include)
+#if __has_include(<asm/mach-realtek/realtek_boottimes.h>)
+#include <asm/mach-realtek/realtek_boottimes.h>
+#define HAVE_BOOTTIMES
+#endif
+#endif
+#ifndef HAVE_BOOTTIMES
+#define rtl_bt_mark(id) do { } while (0)
+#endif
+
 /**
  * Configuration and memory layout
  *
@@ -255,6 +269,8 @@ void loader_main(unsigned long reg_a0, unsigned long reg_a1,
 			      unsigned long);
 	int res;
 
+	rtl_bt_mark(RTL_BT_LOADER_ENTRY);
+
 	/* Initialize compressed data pointers */
 	lzma_init_data();
 
@@ -284,6 +300,7 @@ void loader_main(unsigned long reg_a0, unsigned long reg_a1,
 	}
 
 	printf("done!\n");
+	rtl_bt_mark(RTL_BT_LOADER_UNPACKED);
 
 	/* Ensure decompressed kernel is visible to CPU (flush caches) */
 	flush_cache(kernel_la, lzma_outsize);
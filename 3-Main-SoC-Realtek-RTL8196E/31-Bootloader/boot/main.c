@@ -14,6 +14,7 @@
 #include "cache.h"
 #include "main.h"
 #include "uart.h"
+#include "boottimes.h"
 
 unsigned char *p_kernel_img;
 
@@ -36,6 +37,8 @@ void start_kernel(void)
 	IMG_HEADER_T header;
 	SETTING_HEADER_T setting_header;
 	//-------------------------------------------------------
+	rtl_bt_mark(RTL_BT_BOOT_ENTRY);
+
 	setClkInitConsole();
 
 	initHeap();
@@ -48,6 +51,7 @@ void start_kernel(void)
 
 	return_addr = 0;
 	ret = check_image(&header, &setting_header);
+	rtl_bt_mark(RTL_BT_BOOT_IMAGE);
 
 	invalidate_iram();
 	doBooting(ret, return_addr, &header);
@@ -346,6 +350,7 @@ void goToLocalStartMode(unsigned long addr, IMG_HEADER_Tp pheader)
 
 		jump = (void *)(pheader->startAddr);
 
+		rtl_bt_mark(RTL_BT_BOOT_JUMP);
 		cli();
 		flush_cache();
 		jump(); // jump to start
@@ -12,6 +12,7 @@
 #include "boot_common.h"
 #include "boot_soc.h"
 #include "monitor.h"
+#include "boottimes.h"
 #include "boot_net.h"
 #include "nic.h"
 #include "spi_flash.h"
@@ -135,17 +136,19 @@ volatile int get_timer_jiffies(void) { return jiffies; };
  * @lexra_clock: CPU clock frequency in Hz
  *
  * Configures Timer0 for 10ms (100 Hz) periodic interrupts and
- * sets up the interrupt routing.
+ * sets up the interrupt routing.  Timer1 is left running: it is the
+ * boot timestamp counter started by btcode (see boottimes.h), so the
+ * clock divisor must stay at RTL_BT_TIMER_DIV.
  */
 void timer_init(unsigned long lexra_clock)
 {
-	/* Stop timer and clear any pending interrupt (needed for ramtest
+	/* Stop Timer0 and clear any pending interrupt (needed for ramtest
 	   where the timer is already running from the flash bootcode). */
-	REG32(TCCNR_REG) = 0;
+	REG32(TCCNR_REG) &= RTL_BT_TCCNR_TC1;
 	REG32(TCIR_REG) = (1 << 31) | (1 << 29); /* W1C: TC0IE + TC0IP */
 	jiffies = 0;
 
-#define DIVISOR 0xE
+#define DIVISOR RTL_BT_TIMER_DIV
 #define DIVF_OFFSET 16
 	REG32(CDBR_REG) = (DIVISOR) << DIVF_OFFSET;
 	int SysClkRate = lexra_clock;
@@ -153,8 +156,8 @@ void timer_init(unsigned long lexra_clock)
 #define TICK_100MS_FREQ 1000 /* 1000 Hz */
 #define TICK_FREQ TICK_10MS_FREQ
 	REG32(TC0DATA_REG) = (((SysClkRate / DIVISOR) / TICK_FREQ) + 1) << 4;
-	/* Enable timer */
-	REG32(TCCNR_REG) = (1 << 31) | (1 << 30);
+	/* Enable Timer0, keep Timer1 */
+	REG32(TCCNR_REG) = (1 << 31) | (1 << 30) | RTL_BT_TCCNR_TC1;
 	/* Wait n cycles for timer to re-latch the new value of TC0DATA. */
 	int c;
 	for (c = 0; c < DIVISOR; c++)
@@ -1,4 +1,5 @@
 #include "../boot/include/ver.h"
+#include "../boot/include/boottimes.h"
 typedef unsigned int UINT32;
 #define DECOMP_ADDR 0x80400000
 #define LZMA_STATUS_ADDR 0x80300000
@@ -58,6 +59,10 @@ void boot_entry(void)
 	unsigned char *outbuf;
 	void (*jumpF)(void);
 
+	/* DRAM is usable from here: open the boot timestamp record */
+	rtl_bt_start(RTL_BT_BTCODE_RESET, 0);
+	rtl_bt_mark(RTL_BT_BTCODE_DRAM);
+
 	outbuf = (unsigned char *)(DECOMP_ADDR);
 	{
 #include "LzmaDecode.h"
@@ -109,6 +114,7 @@ void boot_entry(void)
 			return;
 		}
 	}
+	rtl_bt_mark(RTL_BT_BTCODE_UNPACKED);
 	flush_cache_all();
 	jumpF = (void (*)(void))(DECOMP_ADDR);
 	(*jumpF)();
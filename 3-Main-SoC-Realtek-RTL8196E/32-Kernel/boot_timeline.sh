@@ -0,0 +1,83 @@
+#!/bin/bash
+# boot_timeline.sh — Render the boot timeline recorded in /proc/boottimes
+#
+# Usage:
+#   ./boot_timeline.sh <gateway_ip>        # fetch over SSH
+#   ./boot_timeline.sh <boottimes.txt> [dmesg.txt]
+#
+# Each stage (btcode, bootloader, lzma-loader, kernel, rcS) leaves a mark;
+# the bar shows the time spent until the next mark. When the kernel was
+# booted with "initcall_debug" on the command line, the slowest initcalls
+# are listed too, resolved through System.map of the last kernel build.
+#
+# J. Nilo - December 2025
+
+set -e
+
+SCRIPT_DIR="$(cd "$(dirname "$0")" && pwd)"
+SYSTEM_MAP="${SYSTEM_MAP:-${SCRIPT_DIR}/linux-5.10.246-rtl8196e/System.map}"
+SSH_PORT=22
+SSH_USER="root"
+BAR_WIDTH=50
+TOP_INITCALLS=15
+
+if [ -z "$1" ]; then
+    echo "Usage: $0 <gateway_ip | boottimes.txt> [dmesg.txt]"
+    exit 1
+fi
+
+TMP=$(mktemp -d)
+trap 'rm -rf "$TMP"' EXIT
+
+if [ -f "$1" ]; then
+    cp "$1" "$TMP/boottimes"
+    [ -n "$2" ] && [ -f "$2" ] && cp "$2" "$TMP/dmesg"
+else
+    ssh -p "$SSH_PORT" ${SSH_USER}@"$1" "cat /proc/boottimes" > "$TMP/boottimes"
+    ssh -p "$SSH_PORT" ${SSH_USER}@"$1" "dmesg" > "$TMP/dmesg" 2>/dev/null || true
+fi
+
+echo "========================================="
+echo "  BOOT TIMELINE"
+echo "========================================="
+echo ""
+
+# Columns in /proc/boottimes: time_us delta_us name
+awk -v width="$BAR_WIDTH" '
+    BEGIN { n = 0 }
+    /^#/ { next }
+    NF >= 3 { t[n] = $1; name[n] = $3; n++ }
+    END {
+        if (n == 0) { print "No marks found"; exit 1 }
+        total = t[n - 1]
+        printf "%-20s %10s %10s\n", "stage", "at (ms)", "took (ms)"
+        for (i = 0; i < n; i++) {
+            took = (i + 1 < n) ? t[i + 1] - t[i] : 0
+            len = total ? int(took * width / total + 0.5) : 0
+            bar = ""
+            for (j = 0; j < len; j++) bar = bar "#"
+            printf "%-20s %10.1f %10.1f %s\n", name[i], t[i] / 1000, took / 1000, bar
+        }
+        printf "\nTotal: %.2f s\n", total / 1000000
+    }
+' "$TMP/boottimes"
+
+# initcall_debug: "initcall 0x80xxxxxx returned 0 after 1234 usecs"
+if [ -f "$TMP/dmesg" ] && grep -q "initcall .* returned .* after" "$TMP/dmesg"; then
+    echo ""
+    echo "Slowest initcalls:"
+    grep -o "initcall [^ ]* returned [-0-9]* after [0-9]* usecs" "$TMP/dmesg" |
+        awk '{ print $6, $2 }' | sort -rn | head -n "$TOP_INITCALLS" > "$TMP/initcalls"
+    if [ -f "$SYSTEM_MAP" ]; then
+        awk 'NR == FNR { sym[tolower($1)] = $3; next }
+             {
+                 a = tolower($2); sub(/^0x/, "", a); sub(/\+.*/, "", a)
+                 printf "%10d us  %s\n", $1, (a in sym) ? sym[a] : $2
+             }' "$SYSTEM_MAP" "$TMP/initcalls"
+    else
+        awk '{ printf "%10d us  %s\n", $1, $2 }' "$TMP/initcalls"
+    fi
+elif grep -q "initcall_debug=0" "$TMP/boottimes"; then
+    echo ""
+    echo "Boot with initcall_debug in bootargs to list the slowest initcalls."
+fi
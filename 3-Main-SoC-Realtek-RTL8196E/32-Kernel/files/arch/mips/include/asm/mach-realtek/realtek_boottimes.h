@@ -0,0 +1,105 @@
+/*
+ * Realtek RTL819x boot timestamp record
+ *
+ * Each boot stage (btcode, stage-2 bootloader, lzma-loader, kernel) appends
+ * a {stage, Timer1 tick} pair to a small record in the last 4 KiB of RAM.
+ * btcode starts Timer1 at reset as a 28-bit free-running counter at 25 MHz
+ * (200 MHz / 8) and no later stage stops it, so all marks share a single
+ * timebase. The kernel reserves the page (reserved-memory in the DT) and
+ * exposes the result in /proc/boottimes.
+ *
+ * The counter wraps every ~10.7 s: consecutive marks must be closer than
+ * that to be unwrapped correctly.
+ *
+ * Standalone header (no kernel includes): also built into the lzma-loader.
+ * 31-Bootloader/boot/include/boottimes.h is a copy; keep them in sync.
+ *
+ * Copyright (C) 2025 Jacques Nilo
+ */
+#ifndef __REALTEK_BOOTTIMES__
+#define __REALTEK_BOOTTIMES__
+
+#define RTL_BT_PHYS		0x01fff000	/* Last 4 KiB of 32 MiB RAM */
+#define RTL_BT_SIZE		0x1000
+#define RTL_BT_ADDR		(0xa0000000 | RTL_BT_PHYS)	/* KSEG1 */
+#define RTL_BT_MAGIC		0x42544d31	/* "BTM1" */
+#define RTL_BT_MAX		32
+
+/* Timer1 setup shared by every stage */
+#define RTL_BT_HZ		25000000
+#define RTL_BT_TIMER_DIV	8		/* CDBR divisor of the bus clock */
+#define RTL_BT_TC1DATA		0xb8003104
+#define RTL_BT_TC1CNT		0xb800310c
+#define RTL_BT_TCCNR		0xb8003110
+#define RTL_BT_CDBR		0xb8003118
+#define RTL_BT_TCCNR_TC1	((1 << 29) | (1 << 28))	/* TC1EN | TC1MODE */
+#define RTL_BT_MASK		0x0fffffff
+
+/* Stage identifiers, in boot order */
+#define RTL_BT_BTCODE_RESET	1	/* btcode: reset vector, Timer1 start */
+#define RTL_BT_BTCODE_DRAM	2	/* btcode: DRAM calibrated, payload in RAM */
+#define RTL_BT_BTCODE_UNPACKED	3	/* btcode: stage-2 decompressed */
+#define RTL_BT_BOOT_ENTRY	4	/* stage-2: start_kernel() */
+#define RTL_BT_BOOT_IMAGE	5	/* stage-2: kernel image read and checked */
+#define RTL_BT_BOOT_JUMP	6	/* stage-2: ESC window over, jump */
+#define RTL_BT_LOADER_ENTRY	7	/* lzma-loader: entry */
+#define RTL_BT_LOADER_UNPACKED	8	/* lzma-loader: kernel decompressed */
+#define RTL_BT_KERNEL_ENTRY	9	/* kernel: prom_init() */
+#define RTL_BT_KERNEL_TIMER	10	/* kernel: clocksource up */
+
+#ifndef __ASSEMBLER__
+
+struct rtl_bt_entry {
+	unsigned int id;
+	unsigned int tick;
+};
+
+struct rtl_bt_record {
+	unsigned int magic;
+	unsigned int count;
+	struct rtl_bt_entry e[RTL_BT_MAX];
+};
+
+#define RTL_BT_RECORD	((volatile struct rtl_bt_record *)RTL_BT_ADDR)
+
+static inline unsigned int rtl_bt_now(void)
+{
+	return (*(volatile unsigned int *)RTL_BT_TC1CNT >> 4) & RTL_BT_MASK;
+}
+
+/* Start a new record; the entry tick is passed in by btcode */
+static inline void rtl_bt_start(unsigned int id, unsigned int tick)
+{
+	volatile struct rtl_bt_record *r = RTL_BT_RECORD;
+
+	r->e[0].id = id;
+	r->e[0].tick = tick;
+	r->count = 1;
+	r->magic = RTL_BT_MAGIC;
+}
+
+/* Append a mark; silently dropped if no record was started */
+static inline void rtl_bt_mark(unsigned int id)
+{
+	volatile struct rtl_bt_record *r = RTL_BT_RECORD;
+	unsigned int n;
+
+	if (r->magic != RTL_BT_MAGIC)
+		return;
+
+	n = r->count;
+	if (n >= RTL_BT_MAX)
+		return;
+
+	r->e[n].id = id;
+	r->e[n].tick = rtl_bt_now();
+	r->count = n + 1;
+}
+
+/* Implemented in arch/mips/realtek/boottimes.c */
+void rtl819x_boottimes_init(void);
+void rtl819x_boottimes_mark(const char *name);
+
+#endif /* __ASSEMBLER__ */
+
+#endif
@@ -0,0 +1,31 @@
+/*
+ * Realtek RTL819x (RLX4181) D-cache maintenance costs
+ *
+ * A range operation walks the range one 16-byte line at a time with the
+ * CACHE instruction; a full operation toggles one CCTL bit and the core
+ * writes back (and invalidates) the whole 8 KiB D-cache. c-lexra.c times
+ * both at boot and switches to the full operation above the measured
+ * crossover. Drivers that batch buffers for DMA can use the same numbers
+ * to decide between one large and several small calls.
+ *
+ * Copyright (C) 2025 Jacques Nilo
+ */
+#ifndef __REALTEK_CACHE__
+#define __REALTEK_CACHE__
+
+#include <linux/types.h>
+
+struct rlx_dcache_cost {
+	u32 line_flush_ns;	/* CACHE write-back+invalidate, dirty line */
+	u32 line_wback_ns;	/* CACHE write-back, dirty line */
+	u32 full_flush_ns;	/* CCTL write-back+invalidate, dirty cache */
+	u32 full_wback_ns;	/* CCTL write-back, dirty cache */
+	u32 refill_ns;		/* Reloading one line after a full flush */
+};
+
+/* Implemented in arch/mips/mm/c-lexra.c */
+extern unsigned long rlx_dcache_flush_thresh;	/* bytes */
+extern unsigned long rlx_dcache_wback_thresh;	/* bytes */
+extern struct rlx_dcache_cost rlx_dcache_cost;	/* zero if not calibrated */
+
+#endif
@@ -0,0 +1,23 @@
+/*
+ * Realtek RTL819x interrupt dispatch fast path
+ *
+ * With CONFIG_RTL819X_IRQ_FASTPATH, plat_irq_dispatch() calls the handler
+ * of the switch (IP4) and UART1 (IP3) lines directly instead of going
+ * through do_IRQ() and the irq_desc flow handler. The dispatcher stamps
+ * Timer1 on entry; handlers call rtl819x_irq_latency_mark() first thing
+ * so that /proc/irq_fastpath shows the entry-to-handler latency of both
+ * paths.
+ *
+ * Copyright (C) 2025 Jacques Nilo
+ */
+#ifndef __REALTEK_IRQ__
+#define __REALTEK_IRQ__
+
+#ifdef CONFIG_RTL819X_IRQ_FASTPATH
+/* Implemented in arch/mips/realtek/irq-dispatch.c */
+void rtl819x_irq_latency_mark(unsigned int irq);
+#else
+static inline void rtl819x_irq_latency_mark(unsigned int irq) { }
+#endif
+
+#endif
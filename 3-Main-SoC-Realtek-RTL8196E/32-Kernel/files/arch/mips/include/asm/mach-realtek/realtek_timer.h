@@ -0,0 +1,27 @@
+/*
+ * Realtek RTL819x SoC timer access for driver instrumentation
+ *
+ * Timer1 is the free-running clocksource counter (28 bits, 25 MHz with the
+ * 25 MHz reference clock, wraps every ~10.7 s). Drivers use it to timestamp
+ * hot-path events without the cost of ktime_get().
+ *
+ * Copyright (C) 2025 Jacques Nilo
+ */
+#ifndef __REALTEK_TIMER__
+#define __REALTEK_TIMER__
+
+#include <linux/types.h>
+
+#define RTL819X_TIMER_MASK	0x0fffffff	/* 28-bit counter */
+
+/* Implemented in drivers/clocksource/timer-rtl819x.c */
+extern u32 rtl819x_timer_read(void);
+extern u64 rtl819x_timer_ticks_to_ns(u32 ticks);
+
+/* Elapsed ticks between two rtl819x_timer_read() values (wrap-safe) */
+static inline u32 rtl819x_timer_delta(u32 start, u32 end)
+{
+	return (end - start) & RTL819X_TIMER_MASK;
+}
+
+#endif
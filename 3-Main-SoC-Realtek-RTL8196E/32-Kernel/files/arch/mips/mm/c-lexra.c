@@ -6,10 +6,14 @@
  * Port to 5.4: 2025
  */
 
+#include <linux/export.h>
 #include <linux/init.h>
 #include <linux/kernel.h>
 #include <linux/sched.h>
 #include <linux/mm.h>
+#include <linux/gfp.h>
+#include <linux/irqflags.h>
+#include <linux/string.h>
 
 #include <asm/page.h>
 #include <asm/pgtable.h>
@@ -18,6 +22,8 @@
 #include <asm/cpu.h>
 #include <asm/cpu-features.h>
 #include <asm/cacheflush.h>
+#include <asm/mach-realtek/realtek_cache.h>
+#include <asm/mach-realtek/realtek_timer.h>
 
 /*
  * RLX4181 (WULING) Configuration:
@@ -42,6 +48,21 @@
 #define CACHE_DCACHE_FLUSH		0x15	/* D-cache flush */
 #define CACHE_DCACHE_WBACK		0x19	/* D-cache write-back */
 
+#define RLX_DCACHE_SIZE			8192
+#define RLX_DCACHE_LINES		(RLX_DCACHE_SIZE / 16)
+
+/*
+ * Range size above which one CCTL operation on the whole D-cache is
+ * cheaper than walking the range line by line. Defaults to the cache
+ * size until rlx_dcache_calibrate() replaces it with the measurement.
+ */
+unsigned long rlx_dcache_flush_thresh = RLX_DCACHE_SIZE;
+EXPORT_SYMBOL_GPL(rlx_dcache_flush_thresh);
+unsigned long rlx_dcache_wback_thresh = RLX_DCACHE_SIZE;
+EXPORT_SYMBOL_GPL(rlx_dcache_wback_thresh);
+struct rlx_dcache_cost rlx_dcache_cost;
+EXPORT_SYMBOL_GPL(rlx_dcache_cost);
+
 /*
  * Execute CCTL operation on RLX4181/WULING
  * This toggles the operation bits in CP0 $20
@@ -122,7 +143,7 @@ static inline void rlx_flush_dcache_fast(unsigned long start, unsigned long end)
 static inline void rlx_flush_dcache_range(unsigned long start, unsigned long end)
 {
 	/* For large ranges, use CCTL to flush entire cache */
-	if (end - start > 8192) {  /* cpu_dcache_size = 8KB */
+	if (end - start > rlx_dcache_flush_thresh) {
 		CCTL_OP(CCTL_DCACHE_FLUSH);
 		return;
 	}
@@ -131,6 +152,33 @@ static inline void rlx_flush_dcache_range(unsigned long start, unsigned long end
 	rlx_flush_dcache_fast(start, end);
 }
 
+/*
+ * Write back D-cache range without invalidating it
+ * The lines stay valid: used for buffers the device only reads
+ */
+static inline void rlx_wback_dcache_fast(unsigned long start, unsigned long end)
+{
+	unsigned long p;
+
+	for (p = start; p < end; p += 0x080) {
+		CACHE16_UNROLL8(CACHE_DCACHE_WBACK, p);
+	}
+
+	p = p & ~(16 - 1);
+	if (p < end) {
+		CACHE_OP(CACHE_DCACHE_WBACK, p);
+	}
+}
+
+static inline void rlx_wback_dcache_range(unsigned long start, unsigned long end)
+{
+	if (end - start > rlx_dcache_wback_thresh) {
+		CCTL_OP(CCTL_DCACHE_WBACK);
+		return;
+	}
+	rlx_wback_dcache_fast(start, end);
+}
+
 /*
  * Flush I-cache range
  * RLX4181 does NOT have ICACHE_OP, so we must use CCTL to flush entire I-cache
@@ -198,41 +246,33 @@ static inline void rlx_flush_kernel_vmap_range(unsigned long vaddr, int size)
  */
 #ifdef CONFIG_DMA_NONCOHERENT
 
-static inline void rlx_wback_dcache_fast(unsigned long start, unsigned long end)
-{
-	unsigned long p;
-
-	for (p = start; p < end; p += 0x080) {
-		CACHE16_UNROLL8(CACHE_DCACHE_WBACK, p);
-	}
-
-	p = p & ~(16 - 1);
-	if (p < end) {
-		CACHE_OP(CACHE_DCACHE_WBACK, p);
-	}
-}
-
-static inline void rlx_wback_dcache_range(unsigned long start, unsigned long end)
-{
-	if (end - start > 8192) {
-		CCTL_OP(CCTL_DCACHE_WBACK);
-		return;
-	}
-	rlx_wback_dcache_fast(start, end);
-}
-
 static void rlx_dma_cache_wback_inv(unsigned long start, unsigned long size)
 {
 	unsigned long end = start + size;
 	rlx_flush_dcache_range(start, end);
 }
 
+/*
+ * Implemented as a flush: a dirty line at either end of the range may
+ * hold CPU data next to the buffer and must not be dropped. Same
+ * crossover as wback_inv.
+ */
 static void rlx_dma_cache_inv(unsigned long start, unsigned long size)
 {
 	unsigned long end = start + size;
 	rlx_flush_dcache_range(start, end);
 }
 
+/*
+ * Device reads only (TX buffers): keep the lines valid, the CPU usually
+ * touches the same data again (headers, retransmit queue).
+ */
+static void rlx_dma_cache_wback(unsigned long start, unsigned long size)
+{
+	unsigned long end = start + size;
+	rlx_wback_dcache_range(start, end);
+}
+
 #endif /* CONFIG_DMA_NONCOHERENT */
 
 /*
@@ -293,7 +333,7 @@ void lexra_cache_init(void)
 #ifdef CONFIG_DMA_NONCOHERENT
 	_dma_cache_wback_inv = rlx_dma_cache_wback_inv;
 	_dma_cache_inv = rlx_dma_cache_inv;
-	_dma_cache_wback = rlx_dma_cache_wback_inv;
+	_dma_cache_wback = rlx_dma_cache_wback;
 #endif
 
 	build_clear_page();
@@ -307,3 +347,124 @@ void lexra_cache_init(void)
 
 	pr_info("RLX cache: Initialization complete\n");
 }
+
+/*
+ * Boot-time calibration of the range/full crossovers
+ *
+ * Every sample starts from a fully dirty D-cache (the worst case for the
+ * full operation) and is timed with Timer1, interrupts off. The fastest
+ * of RLX_CAL_RUNS samples is kept.
+ *
+ * A range write-back leaves the cache valid, so the crossover is simply
+ * full_wback / line_wback lines. A full flush also throws away every line
+ * outside the range, which then has to be reloaded; with N lines in the
+ * range and L lines in the cache it wins when
+ *
+ *   N * line_flush > full_flush + (L - N) * refill
+ *
+ * i.e. N > (full_flush + L * refill) / (line_flush + refill).
+ */
+#define RLX_CAL_RUNS		8
+#define RLX_CAL_MIN_THRESH	1024
+#define RLX_CAL_MAX_THRESH	65536
+
+enum rlx_cal_op {
+	RLX_CAL_LINE_FLUSH,
+	RLX_CAL_LINE_WBACK,
+	RLX_CAL_FULL_FLUSH,
+	RLX_CAL_FULL_WBACK,
+	RLX_CAL_REFILL,
+};
+
+static u32 __init rlx_dcache_time(unsigned long buf, enum rlx_cal_op op)
+{
+	unsigned long end = buf + RLX_DCACHE_SIZE;
+	u32 best = ~0U, t0, t1;
+	unsigned long flags, p;
+	int i;
+
+	for (i = 0; i < RLX_CAL_RUNS; i++) {
+		local_irq_save(flags);
+		memset((void *)buf, i, RLX_DCACHE_SIZE);
+		if (op == RLX_CAL_REFILL)
+			CCTL_OP(CCTL_DCACHE_FLUSH);
+
+		t0 = rtl819x_timer_read();
+		switch (op) {
+		case RLX_CAL_LINE_FLUSH:
+			rlx_flush_dcache_fast(buf, end);
+			break;
+		case RLX_CAL_LINE_WBACK:
+			rlx_wback_dcache_fast(buf, end);
+			break;
+		case RLX_CAL_FULL_FLUSH:
+			CCTL_OP(CCTL_DCACHE_FLUSH);
+			break;
+		case RLX_CAL_FULL_WBACK:
+			CCTL_OP(CCTL_DCACHE_WBACK);
+			break;
+		case RLX_CAL_REFILL:
+			for (p = buf; p < end; p += 16)
+				(void)*(volatile u32 *)p;
+			break;
+		}
+		t1 = rtl819x_timer_read();
+		local_irq_restore(flags);
+
+		best = min(best, rtl819x_timer_delta(t0, t1));
+	}
+
+	return (u32)rtl819x_timer_ticks_to_ns(best);
+}
+
+static unsigned long __init rlx_dcache_thresh(u32 full, u32 per_line_saved,
+					      u32 per_line)
+{
+	unsigned long lines;
+
+	if (!per_line)
+		return RLX_CAL_MAX_THRESH;
+
+	lines = (full + per_line_saved) / per_line;
+
+	return clamp_t(unsigned long, lines * 16,
+		       RLX_CAL_MIN_THRESH, RLX_CAL_MAX_THRESH);
+}
+
+static int __init rlx_dcache_calibrate(void)
+{
+	struct rlx_dcache_cost *c = &rlx_dcache_cost;
+	unsigned long buf;
+
+	buf = __get_free_pages(GFP_KERNEL, get_order(RLX_DCACHE_SIZE));
+	if (!buf)
+		return -ENOMEM;
+
+	c->line_flush_ns = rlx_dcache_time(buf, RLX_CAL_LINE_FLUSH) /
+			   RLX_DCACHE_LINES;
+	c->line_wback_ns = rlx_dcache_time(buf, RLX_CAL_LINE_WBACK) /
+			   RLX_DCACHE_LINES;
+	c->full_flush_ns = rlx_dcache_time(buf, RLX_CAL_FULL_FLUSH);
+	c->full_wback_ns = rlx_dcache_time(buf, RLX_CAL_FULL_WBACK);
+	c->refill_ns = rlx_dcache_time(buf, RLX_CAL_REFILL) / RLX_DCACHE_LINES;
+
+	free_pages(buf, get_order(RLX_DCACHE_SIZE));
+
+	rlx_dcache_flush_thresh =
+		rlx_dcache_thresh(c->full_flush_ns,
+				  RLX_DCACHE_LINES * c->refill_ns,
+				  c->line_flush_ns + c->refill_ns);
+	rlx_dcache_wback_thresh =
+		rlx_dcache_thresh(c->full_wback_ns, 0, c->line_wback_ns);
+
+	pr_info("RLX cache: line flush %u ns, wback %u ns, refill %u ns; "
+		"full flush %u ns, wback %u ns\n",
+		c->line_flush_ns, c->line_wback_ns, c->refill_ns,
+		c->full_flush_ns, c->full_wback_ns);
+	pr_info("RLX cache: full-cache op above %lu bytes (flush), %lu bytes (wback)\n",
+		rlx_dcache_flush_thresh, rlx_dcache_wback_thresh);
+
+	return 0;
+}
+/* Before device_initcall(): drivers probe with the measured thresholds */
+arch_initcall(rlx_dcache_calibrate);
@@ -0,0 +1,204 @@
+/*
+ * Realtek RTL819x Boot Timestamps
+ *
+ * Collects the boot timestamp record left in reserved RAM by btcode, the
+ * stage-2 bootloader and the lzma-loader (see realtek_boottimes.h), links
+ * it to the kernel clock and exposes the whole timeline in /proc/boottimes:
+ *
+ *   cat /proc/boottimes            - one line per stage, us since reset
+ *   echo rcS.start > /proc/boottimes - add a userspace mark
+ *
+ * Pre-kernel marks are Timer1 ticks. At plat_time_init() the kernel takes
+ * one last tick mark together with sched_clock() (which reads the same
+ * counter), and every later mark is stored in sched_clock() nanoseconds
+ * relative to that anchor.
+ *
+ * Copyright (C) 2025 Jacques Nilo
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 as published
+ * by the Free Software Foundation.
+ */
+
+#include <linux/init.h>
+#include <linux/kernel.h>
+#include <linux/proc_fs.h>
+#include <linux/sched/clock.h>
+#include <linux/seq_file.h>
+#include <linux/spinlock.h>
+#include <linux/string.h>
+#include <linux/uaccess.h>
+
+#include <asm/mach-realtek/realtek_boottimes.h>
+
+/* Kernel and userspace marks kept after the anchor */
+#define RTL_BT_KMAX		32
+#define RTL_BT_NAME_LEN		24
+
+struct rtl_bt_kmark {
+	u64 ns;
+	char name[RTL_BT_NAME_LEN];
+};
+
+static const char * const rtl_bt_stage_names[] = {
+	[RTL_BT_BTCODE_RESET]		= "btcode.reset",
+	[RTL_BT_BTCODE_DRAM]		= "btcode.dram",
+	[RTL_BT_BTCODE_UNPACKED]	= "btcode.unpacked",
+	[RTL_BT_BOOT_ENTRY]		= "boot.entry",
+	[RTL_BT_BOOT_IMAGE]		= "boot.image",
+	[RTL_BT_BOOT_JUMP]		= "boot.jump",
+	[RTL_BT_LOADER_ENTRY]		= "loader.entry",
+	[RTL_BT_LOADER_UNPACKED]	= "loader.unpacked",
+	[RTL_BT_KERNEL_ENTRY]		= "kernel.entry",
+	[RTL_BT_KERNEL_TIMER]		= "kernel.timer",
+};
+
+static struct rtl_bt_entry rtl_bt_pre[RTL_BT_MAX];
+static unsigned int rtl_bt_pre_cnt;
+static u64 rtl_bt_anchor_ns;
+
+static struct rtl_bt_kmark rtl_bt_marks[RTL_BT_KMAX];
+static unsigned int rtl_bt_mark_cnt;
+static DEFINE_SPINLOCK(rtl_bt_lock);
+
+/**
+ * rtl819x_boottimes_init() - Take over the pre-kernel record
+ *
+ * Called from plat_time_init() once the Timer1 clocksource and sched_clock
+ * are registered. The shared record is then invalidated so a bootloader
+ * that does not write one cannot leave a stale copy for the next boot.
+ */
+void __init rtl819x_boottimes_init(void)
+{
+	volatile struct rtl_bt_record *r = RTL_BT_RECORD;
+	unsigned int i;
+
+	rtl_bt_mark(RTL_BT_KERNEL_TIMER);
+	rtl_bt_anchor_ns = sched_clock();
+
+	if (r->magic != RTL_BT_MAGIC)
+		return;
+
+	rtl_bt_pre_cnt = min_t(unsigned int, r->count, RTL_BT_MAX);
+	for (i = 0; i < rtl_bt_pre_cnt; i++) {
+		rtl_bt_pre[i].id = r->e[i].id;
+		rtl_bt_pre[i].tick = r->e[i].tick;
+	}
+	r->magic = 0;
+}
+
+/**
+ * rtl819x_boottimes_mark() - Record a kernel or userspace boot mark
+ * @name: Label shown in /proc/boottimes (truncated to 23 characters)
+ */
+void rtl819x_boottimes_mark(const char *name)
+{
+	u64 now = sched_clock();
+	unsigned long flags;
+
+	spin_lock_irqsave(&rtl_bt_lock, flags);
+	if (rtl_bt_mark_cnt < RTL_BT_KMAX) {
+		rtl_bt_marks[rtl_bt_mark_cnt].ns = now;
+		strscpy(rtl_bt_marks[rtl_bt_mark_cnt].name, name,
+			RTL_BT_NAME_LEN);
+		rtl_bt_mark_cnt++;
+	}
+	spin_unlock_irqrestore(&rtl_bt_lock, flags);
+}
+
+/* First initcall level: end of start_kernel() setup */
+static int __init rtl819x_boottimes_initcalls(void)
+{
+	rtl819x_boottimes_mark("kernel.initcalls");
+	return 0;
+}
+pure_initcall(rtl819x_boottimes_initcalls);
+
+static u64 rtl_bt_ticks_to_us(u64 ticks)
+{
+	return div_u64(ticks, RTL_BT_HZ / USEC_PER_SEC);
+}
+
+static int rtl_bt_show(struct seq_file *m, void *v)
+{
+	u64 t = 0, prev = 0, anchor_us;
+	unsigned long flags;
+	unsigned int i, n;
+
+	seq_printf(m, "# boot timestamps, us since reset (Timer1 %u MHz)\n",
+		   RTL_BT_HZ / 1000000);
+	seq_printf(m, "# initcall_debug=%d\n", initcall_debug);
+
+	/* Pre-kernel marks: unwrap the 28-bit counter mark by mark */
+	for (i = 0; i < rtl_bt_pre_cnt; i++) {
+		unsigned int id = rtl_bt_pre[i].id;
+
+		if (i)
+			t += (rtl_bt_pre[i].tick - rtl_bt_pre[i - 1].tick) &
+			     RTL_BT_MASK;
+		seq_printf(m, "%10llu %10llu %s\n", rtl_bt_ticks_to_us(t),
+			   rtl_bt_ticks_to_us(t) - prev,
+			   id < ARRAY_SIZE(rtl_bt_stage_names) &&
+			   rtl_bt_stage_names[id] ? rtl_bt_stage_names[id] :
+			   "unknown");
+		prev = rtl_bt_ticks_to_us(t);
+	}
+
+	/* Without a pre-kernel record, time is counted from the anchor */
+	anchor_us = rtl_bt_pre_cnt ? rtl_bt_ticks_to_us(t) : 0;
+
+	spin_lock_irqsave(&rtl_bt_lock, flags);
+	n = rtl_bt_mark_cnt;
+	spin_unlock_irqrestore(&rtl_bt_lock, flags);
+
+	for (i = 0; i < n; i++) {
+		u64 us = anchor_us +
+			 div_u64(rtl_bt_marks[i].ns - rtl_bt_anchor_ns,
+				 NSEC_PER_USEC);
+
+		seq_printf(m, "%10llu %10llu %s\n", us, us - prev,
+			   rtl_bt_marks[i].name);
+		prev = us;
+	}
+
+	return 0;
+}
+
+static int rtl_bt_open(struct inode *inode, struct file *file)
+{
+	return single_open(file, rtl_bt_show, NULL);
+}
+
+static ssize_t rtl_bt_write(struct file *file, const char __user *buf,
+			    size_t count, loff_t *ppos)
+{
+	char name[RTL_BT_NAME_LEN], *label;
+	size_t len = min(count, sizeof(name) - 1);
+
+	if (copy_from_user(name, buf, len))
+		return -EFAULT;
+	name[len] = '\0';
+	label = strim(name);
+	if (!label[0])
+		return -EINVAL;
+
+	rtl819x_boottimes_mark(label);
+
+	return count;
+}
+
+static const struct proc_ops rtl_bt_proc_ops = {
+	.proc_open	= rtl_bt_open,
+	.proc_read	= seq_read,
+	.proc_write	= rtl_bt_write,
+	.proc_lseek	= seq_lseek,
+	.proc_release	= single_release,
+};
+
+static int __init rtl819x_boottimes_proc_init(void)
+{
+	if (!proc_create("boottimes", 0644, NULL, &rtl_bt_proc_ops))
+		return -ENOMEM;
+	return 0;
+}
+fs_initcall(rtl819x_boottimes_proc_init);
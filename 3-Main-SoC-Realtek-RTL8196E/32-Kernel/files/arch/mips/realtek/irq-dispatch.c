@@ -17,6 +17,21 @@
 #include <asm/irq_cpu.h>
 #include <asm/mipsregs.h>
 
+#ifdef CONFIG_RTL819X_IRQ_FASTPATH
+#include <linux/export.h>
+#include <linux/irqdesc.h>
+#include <linux/kernel_stat.h>
+#include <linux/proc_fs.h>
+#include <linux/random.h>
+#include <linux/seq_file.h>
+#include <linux/string.h>
+
+#include <asm/mach-realtek/realtek_irq.h>
+#include <asm/mach-realtek/realtek_timer.h>
+
+#include "internals.h"      /* kernel/irq: kstat_incr_irqs_this_cpu() */
+#endif
+
 /* MIPS CPU Interrupt Lines (IP0-IP7) */
 #define REALTEK_CPU_IRQ_CASCADE     2       /* IP2 - Cascaded interrupts (UART0 only) */
 #define REALTEK_CPU_IRQ_UART1       3       /* IP3 - UART1 direct */
@@ -26,6 +41,108 @@
 /* Mask of all known/handled interrupt sources */
 #define REALTEK_HANDLED_IRQS (STATUSF_IP7 | STATUSF_IP4 | STATUSF_IP3 | STATUSF_IP2)
 
+#ifdef CONFIG_RTL819X_IRQ_FASTPATH
+/* Entry-to-handler latency of one delivery path */
+struct rtl819x_irq_lat {
+    u32 count;
+    u32 max_ns;
+    u64 sum_ns;
+};
+
+struct rtl819x_irq_line {
+    unsigned int irq;
+    const char *name;
+    struct irq_desc *desc;
+    u32 direct;                     /* Handler called from the dispatcher */
+    u32 generic;                    /* Sent to do_IRQ() */
+    u32 unhandled;                  /* Direct calls that returned IRQ_NONE */
+    struct rtl819x_irq_lat lat[2];  /* [0] do_IRQ(), [1] direct */
+};
+
+static struct rtl819x_irq_line rtl819x_irq_switch = {
+    .irq = REALTEK_CPU_IRQ_SWITCH, .name = "switch",
+};
+static struct rtl819x_irq_line rtl819x_irq_uart1 = {
+    .irq = REALTEK_CPU_IRQ_UART1, .name = "uart1",
+};
+
+static bool rtl819x_irq_fast = true;    /* /proc/irq_fastpath */
+static u32 rtl819x_irq_entry;           /* Timer1 at plat_irq_dispatch() */
+static bool rtl819x_irq_direct;         /* Path of the current interrupt */
+
+static inline struct rtl819x_irq_line *rtl819x_irq_line_of(unsigned int irq)
+{
+    if (irq == REALTEK_CPU_IRQ_SWITCH)
+        return &rtl819x_irq_switch;
+    if (irq == REALTEK_CPU_IRQ_UART1)
+        return &rtl819x_irq_uart1;
+    return NULL;
+}
+
+/**
+ * rtl819x_irq_handle - Deliver a switch or UART1 interrupt
+ * @l: Line descriptor
+ *
+ * Both lines have exactly one non-threaded handler (rtl819x NIC, 8250
+ * UART1), so the irq_desc lookup and the percpu flow handler of do_IRQ()
+ * only cost time: the handler is called straight from here. The
+ * /proc/interrupts counters and the entropy pool are fed as by
+ * handle_irq_event_percpu(); the spurious interrupt detector
+ * (note_interrupt()) is not.
+ *
+ * Anything unusual - no handler yet, a shared or threaded handler, the
+ * line disabled, fast path switched off - goes through do_IRQ().
+ */
+static __always_inline void rtl819x_irq_handle(struct rtl819x_irq_line *l)
+{
+    struct irq_desc *desc = l->desc;
+    struct irqaction *action = desc ? READ_ONCE(desc->action) : NULL;
+
+    if (unlikely(!rtl819x_irq_fast || !action || action->next ||
+                 action->thread_fn || irqd_irq_disabled(&desc->irq_data))) {
+        l->generic++;
+        rtl819x_irq_direct = false;
+        do_IRQ(l->irq);
+        return;
+    }
+
+    l->direct++;
+    rtl819x_irq_direct = true;
+    irq_enter();
+    kstat_incr_irqs_this_cpu(desc);
+    if (action->handler(l->irq, action->dev_id) == IRQ_NONE)
+        l->unhandled++;
+    add_interrupt_randomness(l->irq, 0);
+    irq_exit();
+}
+
+/**
+ * rtl819x_irq_latency_mark - Account entry-to-handler latency
+ * @irq: Interrupt being handled
+ *
+ * Called by the switch and UART1 handlers before touching the hardware.
+ * Ignored outside hard interrupt context and for other lines.
+ */
+void rtl819x_irq_latency_mark(unsigned int irq)
+{
+    struct rtl819x_irq_line *l = rtl819x_irq_line_of(irq);
+    struct rtl819x_irq_lat *lat;
+    u32 ns;
+
+    if (!l || !in_irq())
+        return;
+
+    ns = (u32)rtl819x_timer_ticks_to_ns(
+            rtl819x_timer_delta(rtl819x_irq_entry, rtl819x_timer_read()));
+    lat = &l->lat[rtl819x_irq_direct];
+    lat->count++;
+    lat->sum_ns += ns;
+    if (ns > lat->max_ns)
+        lat->max_ns = ns;
+}
+EXPORT_SYMBOL_GPL(rtl819x_irq_latency_mark);
+#endif /* CONFIG_RTL819X_IRQ_FASTPATH */
+
 /**
  * plat_irq_dispatch - Top-level MIPS interrupt dispatcher
  *
@@ -38,11 +155,18 @@
  *
  * Note: Uses independent if statements (not else-if) to handle multiple
  * simultaneous interrupts in a single dispatch call, reducing latency.
+ *
+ * With CONFIG_RTL819X_IRQ_FASTPATH, IP4 and IP3 bypass do_IRQ() (see
+ * rtl819x_irq_handle()).
  */
 asmlinkage void plat_irq_dispatch(void)
 {
     unsigned long pending = read_c0_status() & read_c0_cause() & ST0_IM;
 
+#ifdef CONFIG_RTL819X_IRQ_FASTPATH
+    rtl819x_irq_entry = rtl819x_timer_read();
+#endif
+
     if (likely(pending)) {
         /* Timer is the most frequent interrupt (periodic tick) */
         if (likely(pending & STATUSF_IP7)) {
@@ -50,11 +174,19 @@ asmlinkage void plat_irq_dispatch(void)
         }
         /* Switch/Ethernet second most frequent (network traffic) */
         if (pending & STATUSF_IP4) {
+#ifdef CONFIG_RTL819X_IRQ_FASTPATH
+            rtl819x_irq_handle(&rtl819x_irq_switch);
+#else
             do_IRQ(REALTEK_CPU_IRQ_SWITCH);
+#endif
         }
         /* UART1 production traffic */
         if (pending & STATUSF_IP3) {
+#ifdef CONFIG_RTL819X_IRQ_FASTPATH
+            rtl819x_irq_handle(&rtl819x_irq_uart1);
+#else
             do_IRQ(REALTEK_CPU_IRQ_UART1);
+#endif
         }
         /* UART0 cascaded (least frequent) */
         if (pending & STATUSF_IP2) {
@@ -77,4 +209,103 @@ asmlinkage void plat_irq_dispatch(void)
 void __init arch_init_irq(void)
 {
     irqchip_init();
+
+#ifdef CONFIG_RTL819X_IRQ_FASTPATH
+    rtl819x_irq_switch.desc = irq_to_desc(REALTEK_CPU_IRQ_SWITCH);
+    rtl819x_irq_uart1.desc = irq_to_desc(REALTEK_CPU_IRQ_UART1);
+#endif
+}
+
+#ifdef CONFIG_RTL819X_IRQ_FASTPATH
+/*
+ * /proc/irq_fastpath
+ *
+ *   cat /proc/irq_fastpath    - counters and entry-to-handler latency
+ *   echo 0 > /proc/irq_fastpath - deliver through do_IRQ() (1: direct)
+ *
+ * Any write also resets the counters, so the two modes can be compared
+ * under the same load.
+ */
+static void rtl819x_irq_show_line(struct seq_file *m,
+                                  const struct rtl819x_irq_line *l)
+{
+    u64 avg[2] = { 0, 0 };
+    int i;
+
+    for (i = 0; i < 2; i++) {
+        if (l->lat[i].count) {
+            avg[i] = l->lat[i].sum_ns;
+            do_div(avg[i], l->lat[i].count);
+        }
+    }
+
+    seq_printf(m, "%-7s %3u %10u %10u %9u %8llu/%-8u %8llu/%u\n",
+               l->name, l->irq, l->direct, l->generic, l->unhandled,
+               avg[1], l->lat[1].max_ns, avg[0], l->lat[0].max_ns);
+}
+
+static int rtl819x_irq_show(struct seq_file *m, void *v)
+{
+    struct rtl819x_irq_line sw, uart;
+    unsigned long flags;
+
+    local_irq_save(flags);
+    sw = rtl819x_irq_switch;
+    uart = rtl819x_irq_uart1;
+    local_irq_restore(flags);
+
+    seq_printf(m, "mode: %s\n", rtl819x_irq_fast ? "direct" : "do_IRQ");
+    seq_printf(m, "%-7s %3s %10s %10s %9s %17s %s\n", "line", "irq",
+               "direct", "do_IRQ", "unhandled", "direct avg/max ns",
+               "do_IRQ avg/max ns");
+    rtl819x_irq_show_line(m, &sw);
+    rtl819x_irq_show_line(m, &uart);
+
+    return 0;
+}
+
+static int rtl819x_irq_open(struct inode *inode, struct file *file)
+{
+    return single_open(file, rtl819x_irq_show, NULL);
+}
+
+static void rtl819x_irq_reset(struct rtl819x_irq_line *l)
+{
+    l->direct = 0;
+    l->generic = 0;
+    l->unhandled = 0;
+    memset(l->lat, 0, sizeof(l->lat));
+}
+
+static ssize_t rtl819x_irq_write(struct file *file, const char __user *buf,
+                                 size_t count, loff_t *ppos)
+{
+    bool fast, set = !kstrtobool_from_user(buf, count, &fast);
+    unsigned long flags;
+
+    local_irq_save(flags);
+    if (set)
+        rtl819x_irq_fast = fast;
+    rtl819x_irq_reset(&rtl819x_irq_switch);
+    rtl819x_irq_reset(&rtl819x_irq_uart1);
+    local_irq_restore(flags);
+
+    return count;
+}
+
+static const struct proc_ops rtl819x_irq_proc_ops = {
+    .proc_open      = rtl819x_irq_open,
+    .proc_read      = seq_read,
+    .proc_write     = rtl819x_irq_write,
+    .proc_lseek     = seq_lseek,
+    .proc_release   = single_release,
+};
+
+static int __init rtl819x_irq_proc_init(void)
+{
+    if (!proc_create("irq_fastpath", 0644, NULL, &rtl819x_irq_proc_ops))
+        return -ENOMEM;
+    return 0;
 }
+fs_initcall(rtl819x_irq_proc_init);
+#endif /* CONFIG_RTL819X_IRQ_FASTPATH */
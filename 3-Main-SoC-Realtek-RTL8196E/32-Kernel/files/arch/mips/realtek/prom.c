@@ -19,6 +19,8 @@
 #include <asm/setup.h>
 #include <asm/io.h>
 
+#include <asm/mach-realtek/realtek_boottimes.h>
+
 /*
  * UART0 Base Address
  *
@@ -51,6 +53,9 @@
  */
 void __init prom_init(void)
 {
+	/* First kernel boot timestamp (Timer1 is still running from btcode) */
+	rtl_bt_mark(RTL_BT_KERNEL_ENTRY);
+
 	/*
 	 * Setup early console for printk output
 	 *
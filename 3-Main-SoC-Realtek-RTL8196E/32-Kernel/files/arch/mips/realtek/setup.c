@@ -39,6 +39,7 @@
 #include <asm/idle.h>
 
 #include <asm/mach-realtek/realtek_mem.h>
+#include <asm/mach-realtek/realtek_boottimes.h>
 
 /* Watchdog Timer Control Register offset in system controller */
 #define REALTEK_WATCHDOG_TIMER_REG	0x311C
@@ -296,7 +297,8 @@ void __init device_tree_init(void)
  *    realtek,rtl819x-timer driver in drivers/clocksource/.
  *
  * After this function completes, the kernel has working timekeeping and can
- * schedule timer events.
+ * schedule timer events. The boot timestamp record left by the bootloader
+ * is then linked to sched_clock() (see boottimes.c).
  */
 void __init plat_time_init(void)
 {
@@ -305,4 +307,6 @@ void __init plat_time_init(void)
 
 	/* Probe and initialize timer devices from device tree */
 	timer_probe();
+
+	rtl819x_boottimes_init();
 }
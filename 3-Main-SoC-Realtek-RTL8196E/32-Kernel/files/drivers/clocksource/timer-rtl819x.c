@@ -7,6 +7,11 @@
  * - Timer1: Free-running counter for clocksource (monotonic time)
  * - Timer0: One-shot timer for clockevent (scheduling kernel ticks)
  *
+ * Timer1 also backs sched_clock (40 ns resolution at 25 MHz). Timer0 is
+ * stopped after each expiry so that, with NO_HZ_IDLE and high-resolution
+ * timers, the CPU only wakes for the next real event instead of a
+ * periodic HZ tick.
+ *
  * Key features:
  * - 28-bit hardware counters with configurable clock divider
  * - Proper memory barriers (writel/readl) for safe MMIO access
@@ -34,6 +39,8 @@
 #include <linux/sched_clock.h>
 #include <linux/clk.h>
 
+#include <asm/mach-realtek/realtek_timer.h>
+
 /* ========================================================================== */
 /* Hardware Definitions */
 /* ========================================================================== */
@@ -89,7 +96,7 @@ static u64 rtl819x_tc1_count_read(struct clocksource *cs)
  *
  * Provides high-resolution time for scheduler. Must be fast and notrace.
  */
-static u64 __maybe_unused notrace rtl819x_read_sched_clock(void)
+static u64 notrace rtl819x_read_sched_clock(void)
 {
 	return RTLADJ_TICK(tc_r32(REALTEK_TC_REG_COUNT1));
 }
@@ -101,23 +108,55 @@ static struct clocksource rtl819x_clocksource = {
 	.flags	= CLOCK_SOURCE_IS_CONTINUOUS,
 };
 
+/**
+ * rtl819x_timer_read - Raw Timer1 count for driver instrumentation
+ *
+ * Same counter as the clocksource, without timekeeping overhead. Only
+ * differences are meaningful: use rtl819x_timer_delta() and
+ * rtl819x_timer_ticks_to_ns() (see asm/mach-realtek/realtek_timer.h).
+ */
+u32 notrace rtl819x_timer_read(void)
+{
+	return RTLADJ_TICK(tc_r32(REALTEK_TC_REG_COUNT1));
+}
+EXPORT_SYMBOL_GPL(rtl819x_timer_read);
+
+/**
+ * rtl819x_timer_ticks_to_ns - Convert a Timer1 tick delta to nanoseconds
+ * @ticks: Tick delta (at most RTL819X_TIMER_MASK)
+ *
+ * Uses the clocksource mult/shift computed at registration.
+ */
+u64 rtl819x_timer_ticks_to_ns(u32 ticks)
+{
+	return clocksource_cyc2ns(ticks, rtl819x_clocksource.mult,
+				  rtl819x_clocksource.shift);
+}
+EXPORT_SYMBOL_GPL(rtl819x_timer_ticks_to_ns);
+
 /**
  * rtl819x_clocksource_init - Initialize and register clocksource
  * @freq: Timer frequency in Hz
  *
- * Configures Timer1 as free-running counter and registers with kernel
- * timekeeping. Also registers scheduler clock if CPU frequency scaling
- * is disabled.
+ * Configures Timer1 as free-running counter (unless btcode already started
+ * it for the boot timestamps, in which case it is left untouched so the
+ * count stays continuous) and registers with kernel
+ * timekeeping and as scheduler clock. Timer1 runs from the reference
+ * clock, not the CPU clock, so sched_clock is valid whatever the CPU
+ * frequency.
  */
 void __init rtl819x_clocksource_init(unsigned long freq)
 {
 	u32 val;
 
 	/* Configure Timer1 as free-running counter */
-	tc_w32(0xfffffff0, REALTEK_TC_REG_DATA1);
 	val = tc_r32(REALTEK_TC_REG_CTRL);
-	val |= REALTEK_TC_CTRL_TC1_EN | REALTEK_TC_CTRL_TC1_MODE;
-	tc_w32(val, REALTEK_TC_REG_CTRL);
+	if ((val & (REALTEK_TC_CTRL_TC1_EN | REALTEK_TC_CTRL_TC1_MODE)) !=
+	    (REALTEK_TC_CTRL_TC1_EN | REALTEK_TC_CTRL_TC1_MODE)) {
+		tc_w32(0xfffffff0, REALTEK_TC_REG_DATA1);
+		val |= REALTEK_TC_CTRL_TC1_EN | REALTEK_TC_CTRL_TC1_MODE;
+		tc_w32(val, REALTEK_TC_REG_CTRL);
+	}
 
 	/* Clear and disable Timer1 interrupts (not used) */
 	val = tc_r32(REALTEK_TC_REG_IR);
@@ -127,14 +166,12 @@ void __init rtl819x_clocksource_init(unsigned long freq)
 
 	/* Register clocksource with kernel */
 	rtl819x_clocksource.rating = 200;
-	rtl819x_clocksource.mask = CLOCKSOURCE_MASK(REALTEK_TIMER_RESOLUTION),
+	rtl819x_clocksource.mask = CLOCKSOURCE_MASK(REALTEK_TIMER_RESOLUTION);
 
 	clocksource_register_hz(&rtl819x_clocksource, freq);
 
-#ifndef CONFIG_CPU_FREQ
-	/* Register scheduler clock (if CPU freq is fixed) */
+	/* Register scheduler clock (replaces the jiffies-based default) */
 	sched_clock_register(rtl819x_read_sched_clock, REALTEK_TIMER_RESOLUTION, freq);
-#endif
 }
 
 /* ========================================================================== */
@@ -216,6 +253,14 @@ static irqreturn_t rtl819x_timer_interrupt(int irq, void *dev_id)
 	struct clock_event_device *cd = dev_id;
 	u32 tc0_irs;
 
+	/*
+	 * Timer0 reloads from DATA0 on expiry. Stop it so the event really is
+	 * one-shot: with the tick stopped in idle, no further interrupt may
+	 * fire until set_next_event() is called again.
+	 */
+	tc_w32(tc_r32(REALTEK_TC_REG_CTRL) & ~REALTEK_TC_CTRL_TC0_EN,
+	       REALTEK_TC_REG_CTRL);
+
 	/* Acknowledge Timer0 interrupt */
 	tc0_irs = tc_r32(REALTEK_TC_REG_IR);
 	tc0_irs |= REALTEK_TC_IR_TC0_PENDING;
@@ -234,6 +279,7 @@ static struct clock_event_device rtl819x_clockevent = {
 	.features		= CLOCK_EVT_FEAT_ONESHOT,
 	.set_next_event		= rtl819x_timer_set_next_event,
 	.set_state_oneshot	= rtl819x_set_state_oneshot,
+	.set_state_oneshot_stopped = rtl819x_set_state_shutdown,
 	.set_state_shutdown	= rtl819x_set_state_shutdown,
 };
 
@@ -298,7 +344,9 @@ static int __init rtl819x_timer_init(struct device_node *np)
 
 	/* Initialize clocksource and clockevent */
 	rtl819x_clocksource_init(timer_rate);
-	clockevents_config_and_register(&rtl819x_clockevent, timer_rate, 0x300, 0x7fffffff);
+	/* Max delta is the 28-bit counter range (~10.7 s at 25 MHz) */
+	clockevents_config_and_register(&rtl819x_clockevent, timer_rate, 0x300,
+					RTL819X_TIMER_MASK);
 
 	/* Register interrupt handler (using modern request_irq API) */
 	ret = request_irq(rtl819x_clockevent.irq, rtl819x_timer_interrupt,
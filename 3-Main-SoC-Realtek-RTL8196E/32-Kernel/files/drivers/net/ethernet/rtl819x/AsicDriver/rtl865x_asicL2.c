@@ -190,6 +190,8 @@
 
 #define PBPCR (0x14 + OQNCR_BASE)		  /* Port Based Priority Control Register Address Mapping */
 
+#define UPTCMCR0 (0x18 + OQNCR_BASE)		  /* User Priority to Traffic Class Mapping for 1 output queue */
+
 #define DSCPCR0 (0x34 + OQNCR_BASE)		  /*DSCP Priority Control Register Address Mapping. */
 
 #define DSCPCR1 (0x38 + OQNCR_BASE)		  /*DSCP Priority Control Register Address Mapping. */
@@ -1797,6 +1799,31 @@ int32 rtl8651_setAsicOutputQueueNumber(enum PORTID port, enum QUEUENUM qnum)
 	return SUCCESS;
 }
 
+/*
+@func int32 | rtl8651_setAsicPriorityToQIDMappingTable | set user priority to QID mapping for ports with a given queue number
+@parm enum QUEUENUM | qnum | the output queue number (QNUM1~QNUM6)
+@parm enum PRIORITYVALUE | priority | internal priority (PRI0~PRI7)
+@parm enum QUEUEID | qid | output queue ID (QUEUE0~QUEUE5)
+@rvalue SUCCESS |
+@rvalue FAILED | invalid parameter
+@comm
+UPTCMCR0~UPTCMCR5 hold one table per queue number, 3 bits per priority.
+ */
+int32 rtl8651_setAsicPriorityToQIDMappingTable(enum QUEUENUM qnum, enum PRIORITYVALUE priority, enum QUEUEID qid)
+{
+	uint32 reg;
+
+	/* Invalid input parameter */
+	if ((qnum < QNUM1) || (qnum > QNUM6) || (priority < PRI0) || (priority > PRI7) ||
+		(qid < QUEUE0) || (qid >= qnum))
+		return FAILED;
+
+	reg = UPTCMCR0 + ((qnum - QNUM1) << 2);
+	WRITE_MEM32(reg, (READ_MEM32(reg) & ~(0x7 << (3 * priority))) | (qid << (3 * priority)));
+
+	return SUCCESS;
+}
+
 /* 	note: the dynamic mechanism: adjust the flow control threshold value according to the number of Ethernet link up ports.
 	buffer threshold setting:
 	sys on = 208, share on = 192 for link port <=3
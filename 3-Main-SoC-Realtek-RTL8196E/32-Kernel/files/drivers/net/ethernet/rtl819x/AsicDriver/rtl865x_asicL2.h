@@ -234,13 +234,18 @@ int32 rtl8651_getAsicLBParameter( uint32* pToken, uint32* pTick, uint32* pHiThre
 /* Flow Control / Bandwidth functions */
 int32 rtl865xC_setAsicPortPauseFlowControl(uint32 port, uint8 rxEn, uint8 txEn);
 int32 rtl8651_setAsicEthernetBandwidthControl(uint32 port, int8 input, uint32 rate);
+int32 rtl8651_setAsicPortIngressBandwidth(uint32 port, uint32 bandwidth);
+int32 rtl8651_setAsicPortEgressBandwidth(uint32 port, uint32 bandwidth);
 int32 rtl8651_setAsicFlowControlRegister(uint32 port, uint32 enable);
 int32 rtl8651_setAsicSystemInputFlowControlRegister(uint32 fcON, uint32 fcOFF);
 
 /* Initialization functions (added for 5.4 migration) */
 int32 rtl865x_initAsicL2(rtl8651_tblAsic_InitPara_t *para);
 int32 rtl8651_setAsicOutputQueueNumber(uint32 port, uint32 qnum);
+int32 rtl8651_setAsicPriorityToQIDMappingTable(uint32 qnum, uint32 priority, uint32 qid);
 int32 rtl8651_setAsicPvid(uint32 port, uint32 pvid);
 int32 rtl865x_layer2_init(void);
+int32 _rtl865x_ClearFDBEntryByPort(int32 port_num);
+int32 rtl865x_LinkChange_Process(void);
 
 #endif
@@ -11,17 +11,22 @@
 #include "rtl819x.h"
 #include "rtl865x_eventMgr.h"
 
-/*record the allocated memory pool pointer, 
-it can be used when event management module destroyed*/
+/*
+ * Handlers live in a fixed table reached through a direct index of the
+ * eventId (see rtl865x_eventSlot_t), sorted at register time, so raising
+ * an event is one table load plus the handlers for that id: no search,
+ * no list walk, no allocation. eventCnt bounds the total number of
+ * handlers; eventListCnt is still validated but no longer sizes anything.
+ */
 static char eventMgrInitFlag=FALSE;
-static rtl865x_event_t *eventPool;
-static rtl865x_eventLayerList_t *eventLayerListPool;
-static struct rtl865x_eventTables_s eventsTables;
+static uint8 eventIdxTbl[RTL865X_EVENT_IDX_CNT];	/*slot number + 1, 0: none*/
+static rtl865x_eventSlot_t eventSlotTbl[RTL865X_EVENT_SLOT_CNT];
+static uint32 eventSlotCnt;
+static uint32 eventHandlerCnt;
 static rtl865x_eventMgr_param_t eventMgrParam;
 
 int32 rtl865x_initEventMgr(rtl865x_eventMgr_param_t *param)
 {
-	int32 i;
 	memset(&eventMgrParam,0,sizeof(rtl865x_eventMgr_param_t));
 	
 	if(param==NULL)
@@ -59,298 +64,235 @@ int32 rtl865x_initEventMgr(rtl865x_eventMgr_param_t *param)
 		}	
 	}
 	
-	CTAILQ_INIT(&eventsTables.freeList.eventHead);
-	CTAILQ_INIT(&eventsTables.freeList.eventLayerListHead);
-	CTAILQ_INIT(&eventsTables.inuseList.eventLayerListHead);
+	memset(eventIdxTbl, 0, sizeof(eventIdxTbl));
+	memset(eventSlotTbl, 0, sizeof(eventSlotTbl));
+	eventSlotCnt = 0;
+	eventHandlerCnt = 0;
 
-	TBL_MEM_ALLOC(eventPool, rtl865x_event_t, eventMgrParam.eventCnt);
-
-	if(eventPool!=NULL)
-	{
-		memset( eventPool, 0, eventMgrParam.eventCnt * sizeof(rtl865x_event_t));	
-	}
-	else
-	{
-		return FAILED;
-	}
-	
-	TBL_MEM_ALLOC(eventLayerListPool, rtl865x_eventLayerList_t, eventMgrParam.eventListCnt);
+	eventMgrInitFlag=TRUE;
+	return SUCCESS;
+}
 
-	if(eventLayerListPool!=NULL)
-	{
-		memset( eventLayerListPool, 0, eventMgrParam.eventListCnt * sizeof(rtl865x_eventLayerList_t));	
-	}
-	else
+int32 rtl865x_reInitEventMgr(void)
+{
+	if(eventMgrInitFlag==FALSE)
 	{
 		return FAILED;
 	}
 
-	for(i = 0; i<eventMgrParam.eventCnt;i++)
-	{
-		CTAILQ_INSERT_HEAD(&eventsTables.freeList.eventHead, &eventPool[i], next);
-	}
-	
-	for(i = 0; i<eventMgrParam.eventListCnt;i++)
-	{
-		CTAILQ_INSERT_HEAD(&eventsTables.freeList.eventLayerListHead, &eventLayerListPool[i], next);
-	}
-	
-	eventMgrInitFlag=TRUE;
+	memset(eventIdxTbl, 0, sizeof(eventIdxTbl));
+	memset(eventSlotTbl, 0, sizeof(eventSlotTbl));
+	eventSlotCnt = 0;
+	eventHandlerCnt = 0;
 	return SUCCESS;
 }
 
-
-static int32 rtl865x_flushEventLayerList(rtl865x_eventLayerList_t  *eventLayerList)
+/*
+ * Direct index of an eventId: (layer nibble - 1) x 32 plus the sequence
+ * number in the low 5 bits. The layer 2 QoS ids (0x2000100x) bring bit 12
+ * down to bit 4. Every id defined in rtl865x_eventMgr.h gets an index of
+ * its own; any other id that lands on a used index is refused at
+ * register time and finds no handler at raise time.
+ */
+static inline int32 rtl865x_eventIndex(int32 eventId)
 {
-	rtl865x_event_t *event;
-	rtl865x_event_t *nextEvent;
+	uint32 id = (uint32)eventId;
+	uint32 layer = id >> 28;
 
-	if(eventLayerList==NULL)
-	{
-		return SUCCESS;
-	}
-	
-	event = CTAILQ_FIRST(&eventLayerList->eventHead);
-	while(event)
+	if((layer < 1) || (layer > 4))
 	{
-		nextEvent = CTAILQ_NEXT( event, next );
-		event->eventId=0;
-		event->eventPriority=0;
-		event->event_action_fn=NULL;
-		CTAILQ_REMOVE(&eventLayerList->eventHead, event, next);
-		CTAILQ_INSERT_HEAD(&eventsTables.freeList.eventHead, event, next);
-		event = nextEvent;
+		return -1;
 	}
-	return SUCCESS;
+
+	return ((layer - 1) << 5) | (id & 0x1f) | ((id >> 8) & 0x10);
 }
 
-int32 rtl865x_reInitEventMgr(void)
+/*
+ * Find the slot of eventId. With create set, claim a free slot if the id
+ * has none yet. Slots are never released before reinit.
+ */
+static rtl865x_eventSlot_t *rtl865x_searchEventSlot(int32 eventId, int32 create)
 {
-	rtl865x_eventLayerList_t *eventLayerList;
-	rtl865x_eventLayerList_t *nextEventLayerList;
+	rtl865x_eventSlot_t *slot;
+	int32 idx;
 
-	if(eventMgrInitFlag==FALSE)
+	idx = rtl865x_eventIndex(eventId);
+	if(idx < 0)
 	{
-		return FAILED;
+		return NULL;
 	}
-	
-	eventLayerList = TAILQ_FIRST(&eventsTables.inuseList.eventLayerListHead);
-	
-	for (;eventLayerList!=NULL;eventLayerList=nextEventLayerList)
+
+	if(eventIdxTbl[idx] != 0)
 	{
-		nextEventLayerList=TAILQ_NEXT(eventLayerList, next);
-		rtl865x_flushEventLayerList(eventLayerList);
-		
-		CTAILQ_REMOVE(&eventsTables.inuseList.eventLayerListHead, eventLayerList, next);
-		eventLayerList->eventLayerId=0;
-		CTAILQ_INIT(&eventLayerList->eventHead);
-		CTAILQ_INSERT_HEAD(&eventsTables.freeList.eventLayerListHead, eventLayerList, next);
+		slot = &eventSlotTbl[eventIdxTbl[idx] - 1];
+		return (slot->eventId == eventId) ? slot : NULL;
 	}
-	return SUCCESS;
-}
 
+	if((create == FALSE) || (eventSlotCnt == RTL865X_EVENT_SLOT_CNT))
+	{
+		return NULL;
+	}
 
-static rtl865x_eventLayerList_t * rtl865x_searchEventLayerList(rtl865x_event_Param_t *eventParam)
+	slot = &eventSlotTbl[eventSlotCnt++];
+	slot->eventId = eventId;
+	slot->handlerCnt = 0;
+	eventIdxTbl[idx] = eventSlotCnt;
+	return slot;
+}
+
+static int32 rtl865x_searchEvent(rtl865x_eventSlot_t *slot, rtl865x_event_Param_t *eventParam)
 {
-	rtl865x_eventLayerList_t *eventLayerList;
-	CTAILQ_FOREACH(eventLayerList, &eventsTables.inuseList.eventLayerListHead, next)
+	int32 i;
+
+	for(i = 0; i < slot->handlerCnt; i++)
 	{
-		if(eventLayerList->eventLayerId==eventParam->eventLayerId)
+		if(	(slot->handler[i].eventLayerId==eventParam->eventLayerId)
+			&&(slot->handler[i].eventPriority==eventParam->eventPriority)
+			&&(slot->handler[i].event_action_fn== eventParam->event_action_fn))
 		{
-			return eventLayerList;
+			return i;
 		}
 	}
 
-	return NULL;
+	return -1;
 }
 
-static rtl865x_event_t * rtl865x_searchEvent(rtl865x_eventLayerList_t *eventList,rtl865x_event_Param_t *eventParam)
+int32 rtl865x_registerEvent(rtl865x_event_Param_t *eventParam)
 {
-	rtl865x_event_t *event=NULL;
+	rtl865x_eventSlot_t *slot;
+	rtl865x_eventHandler_t *handler;
+	int32 pos;
 	
-	if(eventParam==NULL)
+	if(eventMgrInitFlag==FALSE)
 	{
-		return NULL;
+		return FAILED;
 	}
 	
-	CTAILQ_FOREACH(event, &eventList->eventHead, next)
+	if(eventParam==NULL)
 	{
-		if(	(event->eventId==eventParam->eventId) 
-			&&(event->eventPriority==eventParam->eventPriority)
-			&&(event->event_action_fn== eventParam->event_action_fn))
-		{
-			return event;
-		}	
+		return RTL_EINVALIDINPUT;
 	}
-	
-	return NULL;
-}
 
-static void rtl865x_insertEventLayerList(rtl865x_eventLayerList_t *eventLayerList)
-{
-	rtl865x_eventLayerList_t *tmpEventLayerList=NULL;
-	if(eventLayerList==NULL)
-	{
-		return;
-	}
-	
-	CTAILQ_FOREACH(tmpEventLayerList, &eventsTables.inuseList.eventLayerListHead, next)
+	if(	(eventParam->eventLayerId==0) ||
+		(eventParam->eventId<= 0) || 
+		(eventParam->eventId >MAX_SYSTEM_EVENT_ID) ||
+		(eventParam->event_action_fn == NULL))
+		return RTL_EINVALIDINPUT;
+
+	slot = rtl865x_searchEventSlot(eventParam->eventId, TRUE);
+	if(slot==NULL)
 	{
-		if(tmpEventLayerList->eventLayerId>=eventLayerList->eventLayerId)
-		{
-			CTAILQ_INSERT_BEFORE(&eventsTables.inuseList.eventLayerListHead,tmpEventLayerList,eventLayerList,next);
-			break;	
-		}
+		/*no free slot, or the index belongs to another id*/
+		return RTL_ENOFREEBUFFER;
 	}
-	
-	if(tmpEventLayerList==NULL)
+
+	/*check duplicate entry*/
+	if(rtl865x_searchEvent(slot, eventParam)>=0)
 	{
-		CTAILQ_INSERT_TAIL(&eventsTables.inuseList.eventLayerListHead,eventLayerList,next);
+		return RTL_EENTRYALREADYEXIST;
 	}
-	return;
-	
-}
 
-static void rtl8651_insertEvent(rtl865x_eventLayerList_t *eventLayerList,rtl865x_event_t *event)
-{
-	rtl865x_event_t *tmpEvent=NULL;
-	if( (eventLayerList==NULL) ||(event==NULL))
+	if((slot->handlerCnt==RTL865X_EVENT_SLOT_HANDLERS) || (eventHandlerCnt>=eventMgrParam.eventCnt))
 	{
-		return ; 
+		return RTL_ENOFREEBUFFER;
 	}
-	
-	CTAILQ_FOREACH(tmpEvent, &eventLayerList->eventHead, next)
+
+	/*keep raise order: layer id ascending, then priority ascending, newest first among equals*/
+	for(pos = 0; pos < slot->handlerCnt; pos++)
 	{
-	
-		if((tmpEvent->eventId>event->eventId)||
-			((tmpEvent->eventId== event->eventId) && (tmpEvent->eventPriority>=event->eventPriority)))
+		handler = &slot->handler[pos];
+		if((handler->eventLayerId>eventParam->eventLayerId)||
+			((handler->eventLayerId==eventParam->eventLayerId) && (handler->eventPriority>=eventParam->eventPriority)))
 		{
-			CTAILQ_INSERT_BEFORE(&eventLayerList->eventHead,tmpEvent,event,next);
-			break;	
+			break;
 		}
 	}
 
-	if(tmpEvent==NULL)
-	{
-		CTAILQ_INSERT_TAIL(&eventLayerList->eventHead,event,next);
-	}
-	return ;
-	
+	memmove(&slot->handler[pos + 1], &slot->handler[pos],
+		(slot->handlerCnt - pos) * sizeof(rtl865x_eventHandler_t));
+	handler = &slot->handler[pos];
+	handler->eventLayerId = eventParam->eventLayerId;
+	handler->eventPriority = eventParam->eventPriority;
+	handler->event_action_fn = eventParam->event_action_fn;
+	slot->handlerCnt++;
+	eventHandlerCnt++;
+
+	return SUCCESS;
+		
 }
 
-int32 rtl865x_registerEvent(rtl865x_event_Param_t *eventParam)
+int32 rtl865x_unRegisterEvent(rtl865x_event_Param_t *eventParam)
 {
-	rtl865x_eventLayerList_t *eventLayerList=NULL;
-	rtl865x_event_t *event=NULL;
-	
+	rtl865x_eventSlot_t *slot;
+	int32 pos;
+
 	if(eventMgrInitFlag==FALSE)
 	{
 		return FAILED;
 	}
-	
+
 	if(eventParam==NULL)
 	{
 		return RTL_EINVALIDINPUT;
 	}
 
-	if(eventParam->eventLayerId==0)
-	{
-		return RTL_EINVALIDINPUT;
-	}
-	
-	eventLayerList=rtl865x_searchEventLayerList(eventParam);
-	if(eventLayerList==NULL)
+	slot = rtl865x_searchEventSlot(eventParam->eventId, FALSE);
+	if(slot==NULL)
 	{
-		eventLayerList = CTAILQ_FIRST(&eventsTables.freeList.eventLayerListHead);
-		if(eventLayerList==NULL)
-		{
-			return RTL_ENOFREEBUFFER;
-		}
-		CTAILQ_REMOVE(&eventsTables.freeList.eventLayerListHead, eventLayerList, next);
-		CTAILQ_INIT(&eventLayerList->eventHead);
-		eventLayerList->eventLayerId=eventParam->eventLayerId;
-		rtl865x_insertEventLayerList(eventLayerList);
+		return RTL_EENTRYNOTFOUND;
 	}
 
-	if(	(eventParam->eventId< 0) || 
-		(eventParam->eventId >MAX_SYSTEM_EVENT_ID) ||
-		(eventParam->event_action_fn == NULL))
-		return RTL_EINVALIDINPUT;
-
-	
-	/*check duplicate entry*/
-	event=rtl865x_searchEvent(eventLayerList,eventParam);
-	if(event!=NULL)
+	pos = rtl865x_searchEvent(slot, eventParam);
+	if(pos<0)
 	{
-		return RTL_EENTRYALREADYEXIST;
+		return RTL_EENTRYNOTFOUND;
 	}
-	else
-	{
 
-		event = CTAILQ_FIRST(&eventsTables.freeList.eventHead);
-		if(event==NULL)
-		{
-			return RTL_ENOFREEBUFFER;
-		}
-		CTAILQ_REMOVE( &eventsTables.freeList.eventHead, event, next);
-		event->eventId= eventParam->eventId;
-		event->eventPriority = eventParam->eventPriority;
-		event->event_action_fn = eventParam->event_action_fn;
-		
-		rtl8651_insertEvent(eventLayerList,event);
-	}
+	slot->handlerCnt--;
+	eventHandlerCnt--;
+	memmove(&slot->handler[pos], &slot->handler[pos + 1],
+		(slot->handlerCnt - pos) * sizeof(rtl865x_eventHandler_t));
 
 	return SUCCESS;
-		
 }
 
-
-
 int32 rtl865x_raiseEvent(int32 eventId,void *actionParam)
 {
-	rtl865x_eventLayerList_t *eventLayerList;
-	rtl865x_event_t *event;
+	rtl865x_eventSlot_t *slot;
+	int32 i;
 	int retValue;
 
 	if(eventMgrInitFlag==FALSE)
 	{
 		return FAILED;
 	}
-	
-	CTAILQ_FOREACH(eventLayerList, &eventsTables.inuseList.eventLayerListHead, next)
+
+	slot = rtl865x_searchEventSlot(eventId, FALSE);
+	if(slot==NULL)
+	{
+		return SUCCESS;
+	}
+
+	for(i = 0; i < slot->handlerCnt; i++)
 	{
-		CTAILQ_FOREACH(event, &eventLayerList->eventHead, next)
+		do
+		{
+			retValue=slot->handler[i].event_action_fn(actionParam);
+		}while(retValue==EVENT_RE_EXECUTE);
+		
+		switch(retValue)
 		{
-			if((event->eventId==eventId))
-			{	
-				if(event->event_action_fn!=NULL)
-				{
-					do
-					{
-						retValue=event->event_action_fn(actionParam);
-					}while(retValue==EVENT_RE_EXECUTE);
-					
-					switch(retValue)
-					{
-						
-						case EVENT_STOP_EXECUTE:
-							return SUCCESS;
-
-						case EVENT_CONTINUE_EXECUTE:
-							break;
-							
-						default:
-							break;
-					}
-				}
-			}	
+			
+			case EVENT_STOP_EXECUTE:
+				return SUCCESS;
+
+			case EVENT_CONTINUE_EXECUTE:
+				break;
+				
+			default:
+				break;
 		}
-	
 	}
 	
 	return SUCCESS;
 }
-
-
-
-
@@ -124,37 +124,30 @@ typedef struct action_param_s
 }action_param_t;
 
 
-typedef struct rtl865x_event_s
+/*
+ * Dispatch table: eventIds index a byte table directly (layer nibble x 32
+ * plus sequence number, see rtl865x_eventIndex()), which points to the
+ * slot of that id. A slot holds the handlers of every layer, sorted by
+ * layer id then priority, i.e. in raise order. Slots are claimed and
+ * sorted at register time.
+ */
+#define RTL865X_EVENT_IDX_CNT		128	/* 4 layers x 32 ids */
+#define RTL865X_EVENT_SLOT_CNT		40	/* 33 distinct ids defined above */
+#define RTL865X_EVENT_SLOT_HANDLERS	8
+
+typedef struct rtl865x_eventHandler_s
 {
-	int32 eventId;
+	int32 eventLayerId;
 	int32 eventPriority; /*priority: less value indicate higher priority*/	
 	int32 (*event_action_fn)(void *param);	
-	CTAILQ_ENTRY(rtl865x_event_s) next;
-}rtl865x_event_t;
-
+}rtl865x_eventHandler_t;
 
-typedef CTAILQ_HEAD(_event_head_s, rtl865x_event_s) rtl865x_event_Head_t;
-
-typedef struct rtl865x_eventLayerList_s
+typedef struct rtl865x_eventSlot_s
 {
-	int32 eventLayerId;
-	rtl865x_event_Head_t eventHead; 
-	CTAILQ_ENTRY(rtl865x_eventLayerList_s) next;
-}rtl865x_eventLayerList_t;
-
-typedef CTAILQ_HEAD(_eventLayerList_head_s, rtl865x_eventLayerList_s) rtl865x_eventLayerList_Head_t;
-	
-struct rtl865x_eventTables_s {
-	struct freeEntryList_s {
-		rtl865x_event_Head_t eventHead;
-		rtl865x_eventLayerList_Head_t eventLayerListHead;
-	} freeList;
-
-	struct inuseEntryList_s {
-		rtl865x_eventLayerList_Head_t	eventLayerListHead;
-	} inuseList;
-
-};
+	int32 eventId;		/*0: slot never used*/
+	int32 handlerCnt;
+	rtl865x_eventHandler_t handler[RTL865X_EVENT_SLOT_HANDLERS];
+}rtl865x_eventSlot_t;
 
 int32 rtl865x_initEventMgr(rtl865x_eventMgr_param_t *param);
 int32 rtl865x_reInitEventMgr(void);
@@ -1901,6 +1901,10 @@ int32 rtl865x_init_acl(void)
 @comm
 	ACL rule structure: please refer in header file.
 */
+int32 rtl865x_add_acl(rtl865x_AclRule_t *rule, char *netifName, int32 chainNo)
+{
+	return _rtl865x_add_acl(rule, netifName, chainNo);
+}
 
 /*
 @func int32 | rtl865x_del_acl |del an ACL Rule from the acl chain.
@@ -1914,6 +1918,10 @@ int32 rtl865x_init_acl(void)
 @comm
 	ACL rule structure: please refer in header file.
 */
+int32 rtl865x_del_acl(rtl865x_AclRule_t *rule, char *netifName, int32 chainNo)
+{
+	return _rtl865x_del_acl(rule, netifName, chainNo);
+}
 
 
 
@@ -190,6 +190,13 @@ struct rtl_pktHdr {
 #define PKTHDR_PPPOE_AUTOADD 0x0004
 #define CSUM_TCPUDP_OK 0x0001
 #define CSUM_IP_OK 0x0002
+/*
+ * TX: same bits ask the ALE to fill in the L4 / IPv4 header checksum
+ * (CSUM_TCPUDP / CSUM_IP of the Realtek SDK pkthdr, see the bootloader's
+ * boot/swNic.c)
+ */
+#define CSUM_L4 CSUM_TCPUDP_OK
+#define CSUM_IP CSUM_IP_OK
     uint8 ph_orgtos;   /* RX: original TOS */
     uint8 ph_portlist; /* RX: source port number, TX: destination portmask */
     uint16 ph_vlanId_resv : 1;
@@ -475,6 +482,7 @@ struct rtl_pktHdr {
 #define IF_L2TP 4
 
 #define RTL865X_ACL_USER_USED 0
+#define RTL865X_ACL_QOS_USED -5000	/* after system rules, before user rules */
 
 typedef struct _rtl865x_AclRule_s {
     union {
@@ -726,6 +734,9 @@ typedef struct rtl865x_netif_s {
 } rtl865x_netif_t;
 
 int32 rtl865x_regist_aclChain(char *netifName, int32 priority, uint32 flag);
+int32 rtl865x_flush_allAcl_fromChain(char *netifName, int32 priority, uint32 flag);
+int32 rtl865x_add_acl(rtl865x_AclRule_t *rule, char *netifName, int32 chainNo);
+int32 rtl865x_del_acl(rtl865x_AclRule_t *rule, char *netifName, int32 chainNo);
 int32 rtl865x_initNetifTable(void);
 int32 rtl865x_addNetif(rtl865x_netif_t *netif);
 int32 rtl865x_attachMasterNetif(char *slave, char *master);
@@ -745,6 +745,15 @@ int32 _rtl865x_delFilterDatabaseEntry(uint16 l2Type, uint16 fid, ether_addr_t *
 }
 
 
+/*
+@func int32 | _rtl865x_ClearFDBEntryByPort | Flush the dynamic entries learned on a port.
+@parm int32 | port_num | The port that went down
+@rvalue SUCCESS | Always
+@comm
+	The ASIC has no per-port flush: all RTL8651_L2TBL_ROW x
+	RTL8651_L2TBL_COLUMN entries are read. Process context only, the walk
+	yields between rows and raises EVENT_DEL_FDB with interrupts on.
+*/
 int32 _rtl865x_ClearFDBEntryByPort(int32 port_num)
 {
 	int i, j;
@@ -753,7 +762,7 @@ int32 _rtl865x_ClearFDBEntryByPort(int32 port_num)
 
 	L2buff = &l2entry_tmp;
 	
-	for (i = 0; i < RTL8651_L2TBL_ROW; i++)
+	for (i = 0; i < RTL8651_L2TBL_ROW; i++, cond_resched())
 		for (j = 0; j < RTL8651_L2TBL_COLUMN; j++)
 		{
 			if ((rtl8651_getAsicL2Table(i, j, L2buff))!=SUCCESS)
@@ -100,12 +100,14 @@ int32 rtl865x_setHWL2Table(uint32 row, uint32 column, rtl865x_tblAsicDrv_l2Param
 int32 rtl865x_getHWL2Table(uint32 row, uint32 column, rtl865x_tblAsicDrv_l2Param_t *l2p);
 int32 rtl865x_refleshHWL2Table(ether_addr_t * macAddr, uint32 flags,uint16 fid);
 extern int32 rtl865x_Lookup_fdb_entry(uint32 fid, ether_addr_t *mac, uint32 flags, uint32 *col_num, rtl865x_tblAsicDrv_l2Param_t *L2buff);
+int32 rtl865x_getPortNum(const unsigned char *addr);
 //int32 rtl865x_addFilterDatabaseEntry( uint32 fid, ether_addr_t * mac, uint32 portmask, uint32 type , uint32 isStatic);
 int32 rtl865x_addFilterDatabaseEntry( uint32 fid, ether_addr_t * mac, uint32 portmask, uint32 type );
 int32 rtl865x_addFilterDatabaseEntryExtension( uint16 fid, rtl865x_filterDbTableEntry_t * L2entry);
 int32 rtl865x_getReserveMacAddr(ether_addr_t *macAddr);
 int32 rtl865x_delFilterDatabaseEntry(uint16 l2Type, uint16 fid, ether_addr_t * macAddr); 
 int32 rtl865x_ConvertPortMasktoPortNum(int32 portmask);
+int32 _rtl865x_ClearFDBEntryByPort(int32 port_num);
 int32 rtl865x_delLanFDBEntry(uint16 l2Type,  const unsigned char *addr);
 int32 rtl865x_delAuthLanFDBEntry(uint16 l2Type,  const unsigned char *addr);
 int32 rtl865x_addFDBEntry(const unsigned char *addr);
@@ -0,0 +1,158 @@
+/*
+ * RTL8196E Ethernet Driver - Hot-path tracepoints
+ *
+ * Per-packet events along the descriptor rings:
+ *   rtl819x_rx_harvest  - RX descriptor taken back from the switch core
+ *   rtl819x_rx_skb      - SKB handed to napi_gro_receive()
+ *   rtl819x_tx_enqueue  - TX descriptor given to the switch core
+ *   rtl819x_tx_kick     - TXFD pulse on CPUICR
+ *   rtl819x_tx_done     - TX descriptor reclaimed, SKB freed
+ *
+ * Usage: echo 1 > /sys/kernel/tracing/events/rtl819x/enable
+ *
+ * Copyright (c) 2025 Jacques Nilo
+ * SPDX-License-Identifier: GPL-2.0
+ */
+
+#undef TRACE_SYSTEM
+#define TRACE_SYSTEM rtl819x
+
+#if !defined(_RTL819X_TRACE_H) || defined(TRACE_HEADER_MULTI_READ)
+#define _RTL819X_TRACE_H
+
+#include <linux/skbuff.h>
+#include <linux/tracepoint.h>
+
+TRACE_EVENT(rtl819x_rx_harvest,
+
+	TP_PROTO(int ring, int desc, unsigned int len, unsigned int portlist,
+		 unsigned int reason),
+
+	TP_ARGS(ring, desc, len, portlist, reason),
+
+	TP_STRUCT__entry(
+		__field(int, ring)
+		__field(int, desc)
+		__field(unsigned int, len)
+		__field(unsigned int, portlist)
+		__field(unsigned int, reason)
+	),
+
+	TP_fast_assign(
+		__entry->ring = ring;
+		__entry->desc = desc;
+		__entry->len = len;
+		__entry->portlist = portlist;
+		__entry->reason = reason;
+	),
+
+	TP_printk("ring=%d desc=%d len=%u portlist=0x%x reason=0x%x",
+		  __entry->ring, __entry->desc, __entry->len,
+		  __entry->portlist, __entry->reason)
+);
+
+TRACE_EVENT(rtl819x_rx_skb,
+
+	TP_PROTO(const struct sk_buff *skb, unsigned int vid),
+
+	TP_ARGS(skb, vid),
+
+	TP_STRUCT__entry(
+		__field(const void *, skbaddr)
+		__field(unsigned int, len)
+		__field(u16, protocol)
+		__field(unsigned int, vid)
+	),
+
+	TP_fast_assign(
+		__entry->skbaddr = skb;
+		__entry->len = skb->len;
+		__entry->protocol = ntohs(skb->protocol);
+		__entry->vid = vid;
+	),
+
+	TP_printk("skbaddr=%p len=%u protocol=0x%04x vid=%u",
+		  __entry->skbaddr, __entry->len, __entry->protocol,
+		  __entry->vid)
+);
+
+TRACE_EVENT(rtl819x_tx_enqueue,
+
+	TP_PROTO(int ring, int desc, const void *skb, unsigned int len,
+		 unsigned int portlist),
+
+	TP_ARGS(ring, desc, skb, len, portlist),
+
+	TP_STRUCT__entry(
+		__field(int, ring)
+		__field(int, desc)
+		__field(const void *, skbaddr)
+		__field(unsigned int, len)
+		__field(unsigned int, portlist)
+	),
+
+	TP_fast_assign(
+		__entry->ring = ring;
+		__entry->desc = desc;
+		__entry->skbaddr = skb;
+		__entry->len = len;
+		__entry->portlist = portlist;
+	),
+
+	TP_printk("ring=%d desc=%d skbaddr=%p len=%u portlist=0x%x",
+		  __entry->ring, __entry->desc, __entry->skbaddr,
+		  __entry->len, __entry->portlist)
+);
+
+TRACE_EVENT(rtl819x_tx_kick,
+
+	TP_PROTO(int ring, int desc),
+
+	TP_ARGS(ring, desc),
+
+	TP_STRUCT__entry(
+		__field(int, ring)
+		__field(int, desc)
+	),
+
+	TP_fast_assign(
+		__entry->ring = ring;
+		__entry->desc = desc;
+	),
+
+	TP_printk("ring=%d desc=%d", __entry->ring, __entry->desc)
+);
+
+TRACE_EVENT(rtl819x_tx_done,
+
+	TP_PROTO(int ring, int desc, const void *skb, unsigned int len),
+
+	TP_ARGS(ring, desc, skb, len),
+
+	TP_STRUCT__entry(
+		__field(int, ring)
+		__field(int, desc)
+		__field(const void *, skbaddr)
+		__field(unsigned int, len)
+	),
+
+	TP_fast_assign(
+		__entry->ring = ring;
+		__entry->desc = desc;
+		__entry->skbaddr = skb;
+		__entry->len = len;
+	),
+
+	TP_printk("ring=%d desc=%d skbaddr=%p len=%u",
+		  __entry->ring, __entry->desc, __entry->skbaddr,
+		  __entry->len)
+);
+
+#endif /* _RTL819X_TRACE_H */
+
+/* This part must be outside protection */
+#undef TRACE_INCLUDE_PATH
+#define TRACE_INCLUDE_PATH .
+#undef TRACE_INCLUDE_FILE
+#define TRACE_INCLUDE_FILE rtl819x_trace
+#include <trace/define_trace.h>
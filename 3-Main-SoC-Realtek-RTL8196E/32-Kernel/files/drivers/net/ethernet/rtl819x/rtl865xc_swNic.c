@@ -30,11 +30,12 @@
 #include <linux/if_ether.h>  /* for ETH_ZLEN */
 #include <linux/prefetch.h>
 #include <linux/compiler.h>
-#include <asm/io.h>          /* for dma_cache_wback_inv(), dma_cache_inv() - Kernel 5.4: moved from cacheflush.h */
+#include <asm/io.h>          /* for dma_cache_wback_inv(), dma_cache_wback() - Kernel 5.4: moved from cacheflush.h */
 #include "rtl819x.h"
 #include "rtl865xc_swNic.h"
 #include "AsicDriver/rtl865x_asicCom.h"
 #include "AsicDriver/rtl865x_asicL2.h"
+#include "rtl819x_trace.h"
 
 /* RTL865xC ASIC regs: local-only defines (trimmed from rtl865xc_asicregs.h) */
 #define CPURPDCR1 (0x008 + CPU_IFACE_BASE)	   /* Rx pkthdr descriptor control 1 */
@@ -99,6 +100,11 @@ static unsigned long rtl_swnic_tx_desc_null_errors = 0;
 static unsigned long rtl_swnic_tx_mbuf_null_errors = 0;
 static unsigned long rtl_swnic_tx_desc_index_errors = 0;
 
+/* Phase 8: RX metadata counters, only written from swNic_receive() (NAPI) */
+static unsigned long rtl_swnic_rx_csum_drops;
+static struct rtl_rx_reason_slot rtl_swnic_rx_reasons[RTL_RX_REASON_SLOTS];
+static unsigned long rtl_swnic_rx_reason_other;
+
 /* Accessor function to avoid direct symbol access issues */
 void rtl_swnic_get_error_stats(unsigned long *stats)
 {
@@ -117,12 +123,77 @@ void rtl_swnic_get_error_stats(unsigned long *stats)
 }
 EXPORT_SYMBOL(rtl_swnic_get_error_stats);
 
+/**
+ * rtl_swnic_get_rx_reasons - Copy the RX trap reason histogram
+ * @slots: RTL_RX_REASON_SLOTS entries to fill
+ * @other: Packets whose reason did not fit in the table
+ *
+ * Return: number of slots in use
+ */
+int rtl_swnic_get_rx_reasons(struct rtl_rx_reason_slot *slots, unsigned long *other)
+{
+	int i;
+
+	for (i = 0; i < RTL_RX_REASON_SLOTS && rtl_swnic_rx_reasons[i].count; i++)
+		slots[i] = rtl_swnic_rx_reasons[i];
+	*other = rtl_swnic_rx_reason_other;
+	return i;
+}
+
+unsigned long rtl_swnic_get_rx_csum_drops(void)
+{
+	return rtl_swnic_rx_csum_drops;
+}
+
+/*
+ * Phase 8: ph_reason is kept raw rather than decoded. Only a handful of
+ * values show up on an L2 setup, so a linear scan stops within the first
+ * slots; values beyond the table are summed in rtl_swnic_rx_reason_other.
+ */
+static inline void swNic_countRxReason(uint16 reason)
+{
+	struct rtl_rx_reason_slot *slot;
+	int i;
+
+	for (i = 0; i < RTL_RX_REASON_SLOTS; i++)
+	{
+		slot = &rtl_swnic_rx_reasons[i];
+		if (!slot->count)
+			slot->reason = reason;
+		else if (slot->reason != reason)
+			continue;
+		slot->count++;
+		return;
+	}
+	rtl_swnic_rx_reason_other++;
+}
+
 /* Security fix (2025-11-21): Spinlocks to protect descriptor ring access
  * These locks prevent race conditions when accessing/modifying descriptor indices
  * from multiple contexts (NAPI poll, TX path, etc.)
+ *
+ * Phase 8: The TX ring no longer takes an IRQ-disabling lock. It is a
+ * single-producer/single-consumer ring:
+ *   - Producer: _swNic_send(). Only it writes currTxPkthdrDescIndex.
+ *   - Consumer: swNic_txDone_stats(), from NAPI poll or from the xmit
+ *     reclaim path. Only it writes txPktDoneDescIndex.
+ * The netdev TX queue lock does NOT make the producer single: every
+ * interface (eth0, eth1, ...) has its own queue and all of them send on
+ * TX ring 0. What does is the platform: the RTL8196E is uniprocessor and
+ * ndo_start_xmit() always runs with BHs disabled, so one xmit cannot be
+ * interrupted by another, nor by NAPI. No producer or consumer runs in
+ * hardirq context (no netpoll/netconsole), so interrupts stay enabled
+ * (UART1 RX latency). An SMP build would need a TX ring lock.
+ * Each side still publishes its index with smp_store_release() and reads
+ * the other side's with smp_load_acquire(); on UP they are compiler
+ * barriers. The two consumer call sites are kept apart the same way:
+ * NAPI poll runs in softirq and the xmit reclaim with BHs disabled, so
+ * neither can interrupt the other. No lock is needed, none is taken.
  */
+#ifdef CONFIG_SMP
+#error "rtl819x: the lockless TX ring relies on a uniprocessor, add a TX ring lock for SMP"
+#endif
 static DEFINE_SPINLOCK(rtl_rx_ring_lock);  /* Protects RX descriptor rings */
-static DEFINE_SPINLOCK(rtl_tx_ring_lock);  /* Protects TX descriptor rings */
 
 /* RX Ring */
 static uint32*  rxPkthdrRing[RTL865X_SWNIC_RXRING_HW_PKTDESC];                 /* Point to the starting address of RX pkt Hdr Ring */
@@ -141,6 +212,11 @@ uint32  rxMbufRingCnt;                                                  /* Total
 
 static uint32  size_of_cluster;
 
+/* Ring and pool allocations, kept until swNic_freeRings() */
+static uint32 totalRxPkthdrRingCnt = 0, totalTxPkthdrRingCnt = 0;
+static struct rtl_pktHdr *pPkthdrList_start;
+static struct rtl_mBuf *pMbufList_start;
+
 /* descriptor ring tracing pointers */
 static int32   currRxPkthdrDescIndex[RTL865X_SWNIC_RXRING_HW_PKTDESC];      /* Rx pkthdr descriptor to be handled by CPU */
 static int32   currRxMbufDescIndex;        /* Rx mbuf descriptor to be handled by CPU */
@@ -148,6 +224,20 @@ static int32   currRxMbufDescIndex;        /* Rx mbuf descriptor to be handled b
 static int32   currTxPkthdrDescIndex[RTL865X_SWNIC_TXRING_HW_PKTDESC];      /* Tx pkthdr descriptor to be handled by CPU */
 static int32 txPktDoneDescIndex[RTL865X_SWNIC_TXRING_HW_PKTDESC];
 
+#ifdef CONFIG_RTL819X_LATENCY_HIST
+/* Phase 8: Timer1 stamp per ring 0 TX descriptor, for tx_latency */
+static u32 txEnqueueTicks[NUM_TX_PKTHDR_DESC_MAX];
+#endif
+
+/* Phase 8: TX fragment mbuf pool (scatter-gather). Mbufs are taken and
+ * given back in TX ring order, so the pool is another SPSC ring: only
+ * _swNic_send() moves txFragMbufCurr, only swNic_txDone_stats() moves
+ * txFragMbufDone.
+ */
+static struct rtl_mBuf *txFragMbuf;
+static int32 txFragMbufCurr;
+static int32 txFragMbufDone;
+
 static int32   rxDescReadyForHwIndex[RTL865X_SWNIC_RXRING_HW_PKTDESC];
 static int32   rxDescCrossBoundFlag[RTL865X_SWNIC_RXRING_HW_PKTDESC];
 
@@ -383,6 +473,21 @@ static int __swNic_geRxRingIdx(uint32 rxRingIdx, uint32 *currRxPktDescIdx)
 	return FAILED;
 }
 
+/*
+ * Phase 8: Pick the next RX ring with a harvestable descriptor, priority
+ * ring first. Returns the ring index, or -1 if every CPU ring is empty.
+ */
+static inline int swNic_nextRxRing(uint32 *currRxPktDescIdx)
+{
+	int ring;
+
+	for (ring = RTL_CPU_RX_RING_NUM - 1; ring >= 0; ring--)
+		if (__swNic_geRxRingIdx(ring, currRxPktDescIdx) == SUCCESS)
+			return ring;
+
+	return -1;
+}
+
 /**
  * swNic_receive - Receive one packet from RX descriptor ring
  * @info: Pointer to rtl_nicRx_info structure (filled on success)
@@ -458,6 +563,7 @@ int32 swNic_receive(rtl_nicRx_info *info, int retryCount)
 	void *skb;
 	uint32 rxRingIdx;
 	uint32 currRxPktDescIdx;
+	int ring;
 
 	/* Validate input */
 	if (!info) {
@@ -465,10 +571,11 @@ int32 swNic_receive(rtl_nicRx_info *info, int retryCount)
 	}
 
 get_next:
-	 /* Check OWN bit of descriptors */
-	rxRingIdx = 0;
-	if (__swNic_geRxRingIdx(rxRingIdx,&currRxPktDescIdx)==SUCCESS)
+	 /* Check OWN bit of descriptors, priority ring before bulk ring 0 */
+	ring = swNic_nextRxRing(&currRxPktDescIdx);
+	if (ring >= 0)
 	{
+		rxRingIdx = ring;
 		/* Bounds check already done in __swNic_geRxRingIdx */
 
 		/* Fetch pkthdr */
@@ -517,6 +624,7 @@ get_next:
 		/* Drop on checksum error */
 		if ((pPkthdr->ph_flags & (CSUM_TCPUDP_OK | CSUM_IP_OK)) != (CSUM_TCPUDP_OK | CSUM_IP_OK))
 		{
+			rtl_swnic_rx_csum_drops++;
 			RTL_ETH_NIC_DROP_RX_PKT_RESTART;
 			goto get_next;
 		}
@@ -526,9 +634,18 @@ get_next:
 		 * do not update it when CONFIG_RTL_HARDWARE_NAT is defined
 		 */
 		info->vid=pPkthdr->ph_vlanId;
+		info->vlanTagged=pPkthdr->ph_vlanTagged;
 
 		info->pid=pPkthdr->ph_portlist;
 
+		/* Phase 8: ASIC priority decision and original TOS for skb->priority */
+		info->priority = pPkthdr->ph_rxPktPriority;
+		info->tos = pPkthdr->ph_orgtos;
+		swNic_countRxReason(pPkthdr->ph_reason);
+
+		trace_rtl819x_rx_harvest(rxRingIdx, currRxPktDescIdx, pPkthdr->ph_len,
+					 pPkthdr->ph_portlist, pPkthdr->ph_reason);
+
 		/*
 		 * CRITICAL FIX: Restore synchronous buffer allocation (original mechanism)
 		 * =========================================================================
@@ -576,30 +693,90 @@ get_next:
 
 #undef	RTL_ETH_NIC_DROP_RX_PKT_RESTART
 
+/**
+ * swNic_chainTxFrags - Chain one pool mbuf per skb page fragment
+ * @pMbuf: First mbuf of the packet (carries the linear part)
+ * @skb: Packet with at least one page fragment
+ *
+ * Writes back each fragment and its mbuf so the switch core can follow
+ * the m_next chain. The last mbuf of the chain carries MBUF_EOR.
+ *
+ * Return: 0 on success, -1 if the pool cannot hold all fragments
+ */
+static int swNic_chainTxFrags(struct rtl_mBuf *pMbuf, struct sk_buff *skb)
+{
+	int nr_frags = skb_shinfo(skb)->nr_frags;
+	int curr = txFragMbufCurr;
+	int done = smp_load_acquire(&txFragMbufDone);
+	int used, i;
+	struct rtl_mBuf *pPrev = pMbuf, *pFrag = NULL;
+
+	used = curr - done;
+	if (used < 0)
+		used += NUM_TX_FRAG_MBUF;
+	if (unlikely(NUM_TX_FRAG_MBUF - 1 - used < nr_frags))
+		return -1;
+
+	for (i = 0; i < nr_frags; i++) {
+		const skb_frag_t *frag = &skb_shinfo(skb)->frags[i];
+		uint8 *addr = skb_frag_address(frag);
+
+		pFrag = &txFragMbuf[curr];
+		pFrag->m_next = NULL;
+		pFrag->m_pkthdr = pMbuf->m_pkthdr;
+		pFrag->m_len = skb_frag_size(frag);
+		pFrag->m_extsize = pFrag->m_len;
+		pFrag->m_flags = MBUF_USED | MBUF_EXT;
+		pFrag->m_data = addr;
+		pFrag->m_extbuf = addr;
+		pFrag->skb = NULL;
+		dma_cache_wback((unsigned long)addr, pFrag->m_len);
+
+		pPrev->m_next = pFrag;
+		if (pPrev != pMbuf)
+			dma_cache_wback_inv((unsigned long)pPrev, sizeof(struct rtl_mBuf));
+		pPrev = pFrag;
+
+		if (++curr == NUM_TX_FRAG_MBUF)
+			curr = 0;
+	}
+
+	pMbuf->m_flags &= ~MBUF_EOR;
+	pFrag->m_flags |= MBUF_EOR;
+	dma_cache_wback_inv((unsigned long)pFrag, sizeof(struct rtl_mBuf));
+
+	txFragMbufCurr = curr;
+	return 0;
+}
+
 /**
  * _swNic_send - Internal: Send packet via TX descriptor ring
  * @skb: Socket buffer (stored in descriptor for later free)
- * @output: Pointer to packet data buffer
- * @len: Packet length in bytes
+ * @output: Pointer to packet data buffer (linear part)
+ * @len: Packet length in bytes, page fragments included
  * @nicTx: TX info structure (portlist, flags, VLAN ID, ring index)
  *
  * Core TX function. Validates parameters, checks ring space, fills
  * packet header descriptor, flushes DMA cache, sets ownership bit,
- * and triggers hardware fetch via TXFD pulse.
+ * and triggers hardware fetch via TXFD pulse. Page fragments are sent
+ * from a chain of mbufs (see swNic_chainTxFrags()).
  *
- * Security: Protected by spinlock to prevent concurrent access from
- * multiple TX contexts and NAPI poll.
+ * Lockless producer side of the TX ring (see the TX ring comment above):
+ * the caller must run with BHs disabled, as ndo_start_xmit() does. Several
+ * netdevs share the ring, so their TX queue locks do not serialize it; the
+ * uniprocessor does. Interrupts stay enabled.
  *
- * Cache coherency: Explicit dma_cache_wback_inv() before ownership
- * transfer to ensure hardware sees correct packet data.
+ * Cache coherency: Explicit dma_cache_wback() before ownership
+ * transfer to ensure hardware sees correct packet data. The switch core
+ * only reads TX buffers, so the lines are written back but left valid.
  *
  * Return: Descriptor index on success, -1 on error (ring full, invalid params)
  */
 static __always_inline int32 _swNic_send(void *skb, void * output, uint32 len,rtl_nicTx_info *nicTx)
 {
     struct rtl_pktHdr * pPkthdr;
-    int next_index, ret;
-    unsigned long flags;
+    int next_index, ret, curr, done;
+    uint32 headlen;
 #if RTL_FIX_TX_KICK_ONCE
     int was_empty = 0;
 #endif
@@ -624,36 +801,36 @@ static __always_inline int32 _swNic_send(void *skb, void * output, uint32 len,rt
 		return -1;
 	}
 
-	/* Security fix: Lock TX ring for duration of enqueue operation
-	 * Protects currTxPkthdrDescIndex and txPktDoneDescIndex from races
+	/* Phase 8: Producer owns currTxPkthdrDescIndex; acquire pairs with the
+	 * release in swNic_txDone_stats() so a slot is only reused once the
+	 * consumer has cleared its skb pointer.
 	 */
-	spin_lock_irqsave(&rtl_tx_ring_lock, flags);
+	curr = currTxPkthdrDescIndex[nicTx->txIdx];
+	done = smp_load_acquire(&txPktDoneDescIndex[nicTx->txIdx]);
 
 	/* Bounds check on current descriptor index */
-	if (unlikely(currTxPkthdrDescIndex[nicTx->txIdx] >= txPkthdrRingCnt[nicTx->txIdx])) {
+	if (unlikely(curr >= txPkthdrRingCnt[nicTx->txIdx])) {
 		rtl_swnic_tx_desc_index_errors++;
 		if (__ratelimit(&rtl_swnic_err_limit)) {
 			printk(KERN_WARNING "rtl819x_swnic: TX desc index OOB: ring=%d idx=%d max=%d\n",
-			       nicTx->txIdx, currTxPkthdrDescIndex[nicTx->txIdx], txPkthdrRingCnt[nicTx->txIdx]);
+			       nicTx->txIdx, curr, txPkthdrRingCnt[nicTx->txIdx]);
 		}
-		spin_unlock_irqrestore(&rtl_tx_ring_lock, flags);
 		return -1;
 	}
 
-	if ((currTxPkthdrDescIndex[nicTx->txIdx]+1)==txPkthdrRingCnt[nicTx->txIdx])
+	if ((curr+1)==txPkthdrRingCnt[nicTx->txIdx])
 		next_index = 0;
 	else
-		next_index = currTxPkthdrDescIndex[nicTx->txIdx]+1;
+		next_index = curr+1;
 
-	if (unlikely(next_index == txPktDoneDescIndex[nicTx->txIdx]))	{
+	if (unlikely(next_index == done))	{
 		/*	TX ring full	*/
 		/* Note: this is normal under load, don't spam logs */
-		spin_unlock_irqrestore(&rtl_tx_ring_lock, flags);
 		return -1;
 	}
 
 	/* Fetch packet header from Tx ring */
-	pPkthdr = (struct rtl_pktHdr *) ((int32) txPkthdrRing[nicTx->txIdx][currTxPkthdrDescIndex[nicTx->txIdx]]
+	pPkthdr = (struct rtl_pktHdr *) ((int32) txPkthdrRing[nicTx->txIdx][curr]
                                                 & ~(DESC_OWNED_BIT | DESC_WRAP));
 
 	/* NULL check on hardware-provided pointer */
@@ -666,7 +843,6 @@ static __always_inline int32 _swNic_send(void *skb, void * output, uint32 len,rt
 			printk(KERN_ERR "rtl819x_swnic: NULL in TX ring %d: pPkthdr=%p mbuf=%p\n",
 			       nicTx->txIdx, pPkthdr, pPkthdr ? pPkthdr->ph_mbuf : NULL);
 		}
-		spin_unlock_irqrestore(&rtl_tx_ring_lock, flags);
 		return -1;
 	}
 
@@ -682,12 +858,21 @@ static __always_inline int32 _swNic_send(void *skb, void * output, uint32 len,rt
 	if (len > 1518) {
 		if (__ratelimit(&rtl_swnic_err_limit))
 			printk(KERN_WARNING "rtl819x_swnic: TX len too large: %u (>1522)\n", len);
-		spin_unlock_irqrestore(&rtl_tx_ring_lock, flags);
 		return -1;
 	}
 
-	pPkthdr->ph_mbuf->m_len  = len;
-	pPkthdr->ph_mbuf->m_extsize = len;
+	/* Linear part in the pkthdr's own mbuf, page fragments chained behind */
+	headlen = len;
+	pPkthdr->ph_mbuf->m_next = NULL;
+	pPkthdr->ph_mbuf->m_flags = MBUF_USED | MBUF_EXT | MBUF_PKTHDR | MBUF_EOR;
+	if (skb_shinfo((struct sk_buff *)skb)->nr_frags) {
+		headlen = skb_headlen((struct sk_buff *)skb);
+		if (swNic_chainTxFrags(pPkthdr->ph_mbuf, skb) < 0)
+			return -1;	/* pool exhausted: same as ring full */
+	}
+
+	pPkthdr->ph_mbuf->m_len  = headlen;
+	pPkthdr->ph_mbuf->m_extsize = headlen;
 	pPkthdr->ph_mbuf->skb = skb;
 	pPkthdr->ph_len = len;
 
@@ -695,6 +880,9 @@ static __always_inline int32 _swNic_send(void *skb, void * output, uint32 len,rt
 	pPkthdr->ph_portlist = nicTx->portlist&0x1f;
 	pPkthdr->ph_srcExtPortNum = nicTx->srcExtPort;
 	pPkthdr->ph_flags = nicTx->flags;
+	pPkthdr->ph_flags2 = 0;
+	pPkthdr->ph_txCVlanTagAutoAdd = nicTx->vlanTagPorts & 0x3f;
+	pPkthdr->ph_txPriority = nicTx->priority;
 
 
 
@@ -714,7 +902,7 @@ static __always_inline int32 _swNic_send(void *skb, void * output, uint32 len,rt
 	 * This fixes 48% TCP retransmission rate caused by corrupted TX packets.
 	 * Must writeback BEFORE setting DESC_SWCORE_OWNED bit.
 	 */
-	dma_cache_wback_inv((unsigned long)output, len);
+	dma_cache_wback((unsigned long)output, headlen);
 
 	/* Writeback descriptor structures */
 	dma_cache_wback_inv((unsigned long)pPkthdr, sizeof(struct rtl_pktHdr));
@@ -722,14 +910,18 @@ static __always_inline int32 _swNic_send(void *skb, void * output, uint32 len,rt
 
     /* Was ring empty before enqueue? Used by optional TX kick optimization */
 #if RTL_FIX_TX_KICK_ONCE
-    was_empty = (txPktDoneDescIndex[nicTx->txIdx] == currTxPkthdrDescIndex[nicTx->txIdx]);
+    was_empty = (done == curr);
 #endif
 
-    ret = currTxPkthdrDescIndex[nicTx->txIdx];
+    ret = curr;
+#ifdef CONFIG_RTL819X_LATENCY_HIST
+    if (nicTx->txIdx == 0)
+        txEnqueueTicks[ret] = rtl819x_timer_read();
+#endif
 #if RTL_FIX_TX_INDEX_AFTER_OWNERSHIP
     /* Defer index advance until after giving descriptor to hardware */
 #else
-    currTxPkthdrDescIndex[nicTx->txIdx] = next_index;
+    smp_store_release(&currTxPkthdrDescIndex[nicTx->txIdx], next_index);
 #endif
 
 	/* Ensure all descriptor writes complete before giving to hardware */
@@ -740,12 +932,13 @@ static __always_inline int32 _swNic_send(void *skb, void * output, uint32 len,rt
     wmb();
 
 #if RTL_FIX_TX_INDEX_AFTER_OWNERSHIP
-    /* Advance producer index only after descriptor ownership is transferred */
-    currTxPkthdrDescIndex[nicTx->txIdx] = next_index;
+    /* Advance producer index only after descriptor ownership is transferred
+     * (release: the consumer must see the filled slot before the index)
+     */
+    smp_store_release(&currTxPkthdrDescIndex[nicTx->txIdx], next_index);
 #endif
 
-	/* Security fix: Release TX ring lock after index update */
-	spin_unlock_irqrestore(&rtl_tx_ring_lock, flags);
+    trace_rtl819x_tx_enqueue(nicTx->txIdx, ret, skb, len, nicTx->portlist);
 
     /* Trigger TX fetch with a pulse while preserving configuration bits.
      * Do NOT write a raw '= TXFD' as CPUICR contains enable/config flags
@@ -754,6 +947,7 @@ static __always_inline int32 _swNic_send(void *skb, void * output, uint32 len,rt
 #if RTL_FIX_TX_KICK_ONCE
     if (was_empty) {
         unsigned long icr_snapshot = REG32(CPUICR);
+        trace_rtl819x_tx_kick(nicTx->txIdx, ret);
         /* Set TXFD edge */
         REG32(CPUICR) = icr_snapshot | TXFD;
         wmb();
@@ -766,6 +960,7 @@ static __always_inline int32 _swNic_send(void *skb, void * output, uint32 len,rt
 #else
     {
         unsigned long icr_snapshot = REG32(CPUICR);
+        trace_rtl819x_tx_kick(nicTx->txIdx, ret);
         REG32(CPUICR) = icr_snapshot | TXFD;
         wmb();
         (void)REG32(CPUICR);
@@ -781,23 +976,18 @@ static __always_inline int32 _swNic_send(void *skb, void * output, uint32 len,rt
 /**
  * swNic_send - Send packet via TX descriptor ring (public API)
  * @skb: Socket buffer (stored in descriptor for later free)
- * @output: Pointer to packet data buffer
- * @len: Packet length in bytes
+ * @output: Pointer to packet data buffer (linear part)
+ * @len: Packet length in bytes, page fragments included
  * @nicTx: TX info structure (portlist, flags, VLAN ID, ring index)
  *
- * Public wrapper around _swNic_send() with IRQ protection.
+ * Public wrapper around _swNic_send(). Must be called with the netdev TX
+ * queue lock held (ndo_start_xmit); interrupts are not disabled.
  *
  * Return: Descriptor index on success, -1 on error
  */
 int32 swNic_send(void *skb, void * output, uint32 len,rtl_nicTx_info *nicTx)
 {
-	int	ret;
-	unsigned long flags;
-
-	local_irq_save(flags);
-	ret = _swNic_send(skb, output, len, nicTx);
-	local_irq_restore(flags);
-	return ret;
+	return _swNic_send(skb, output, len, nicTx);
 }
 
 /**
@@ -811,21 +1001,27 @@ int32 swNic_send(void *skb, void * output, uint32 len,rtl_nicTx_info *nicTx)
  */
 int32 swNic_txRingFreeCount(int idx)
 {
-	int free_count;
+	int free_count, curr, done;
 
 	/* Validate TX ring index */
 	if (idx >= RTL865X_SWNIC_TXRING_HW_PKTDESC) {
 		return -1;
 	}
 
+	/* Lockless snapshot: may be stale by a few descriptors, which the
+	 * stop/wake hysteresis in rtl_nic.c absorbs.
+	 */
+	curr = READ_ONCE(currTxPkthdrDescIndex[idx]);
+	done = READ_ONCE(txPktDoneDescIndex[idx]);
+
 	/* Calculate free descriptors with wrap-around handling
 	 * Free space = (done_idx - curr_idx - 1) mod ring_size
 	 * We reserve 1 descriptor to distinguish full from empty.
 	 */
-	if (txPktDoneDescIndex[idx] > currTxPkthdrDescIndex[idx]) {
-		free_count = txPktDoneDescIndex[idx] - currTxPkthdrDescIndex[idx] - 1;
-	} else if (txPktDoneDescIndex[idx] < currTxPkthdrDescIndex[idx]) {
-		free_count = txPkthdrRingCnt[idx] - currTxPkthdrDescIndex[idx] + txPktDoneDescIndex[idx] - 1;
+	if (done > curr) {
+		free_count = done - curr - 1;
+	} else if (done < curr) {
+		free_count = txPkthdrRingCnt[idx] - curr + done - 1;
 	} else {
 		/* Indexes equal: ring is empty */
 		free_count = txPkthdrRingCnt[idx] - 1;
@@ -857,6 +1053,10 @@ int32 swNic_txDone(int idx)
  * frees completed SKBs, and advances done index. Includes DMA cache
  * invalidation fix for MIPS to prevent packet duplication.
  *
+ * Phase 8: Lockless consumer side of the TX ring. Must run with BHs
+ * disabled (NAPI poll or ndo_start_xmit()), which on this uniprocessor
+ * keeps the two callers apart. Interrupts stay enabled.
+ *
  * Return: Number of packets freed
  */
 int32 swNic_txDone_stats(int idx, unsigned int *pkts_out, unsigned int *bytes_out)
@@ -864,19 +1064,24 @@ int32 swNic_txDone_stats(int idx, unsigned int *pkts_out, unsigned int *bytes_ou
 	struct rtl_pktHdr	*pPkthdr;
 	struct sk_buff *skb;
 	unsigned int pkts = 0, bytes = 0;
-	unsigned long flags;
+	int done, curr;
 
 	/* Validate TX ring index */
 	if (idx >= RTL865X_SWNIC_TXRING_HW_PKTDESC) {
 		return 0;
 	}
 
-	local_irq_save(flags);
+	/* The exclusion the lockless ring relies on, see above */
+	WARN_ON_ONCE(!in_softirq());
+
+	done = txPktDoneDescIndex[idx];
+	/* Acquire pairs with the producer's release: slots up to curr are filled */
+	curr = smp_load_acquire(&currTxPkthdrDescIndex[idx]);
 	{
-		while (txPktDoneDescIndex[idx] != currTxPkthdrDescIndex[idx]) {
+		while (done != curr) {
 
 		/* Bounds check on descriptor index */
-		if (txPktDoneDescIndex[idx] >= txPkthdrRingCnt[idx]) {
+		if (done >= txPkthdrRingCnt[idx]) {
 			break;
 		}
 
@@ -891,16 +1096,16 @@ int32 swNic_txDone_stats(int idx, unsigned int *pkts_out, unsigned int *bytes_ou
 		 * This fixes 49% TCP "retransmissions" which are actually duplicated
 		 * packets sent because driver reused descriptors before HW finished.
 		 */
-		dma_cache_inv((unsigned long)&txPkthdrRing[idx][txPktDoneDescIndex[idx]], sizeof(uint32));
+		dma_cache_inv((unsigned long)&txPkthdrRing[idx][done], sizeof(uint32));
 
 		/* Ensure we read latest descriptor state from hardware */
 		rmb();
 
-		if ( (*(volatile uint32 *)&txPkthdrRing[idx][txPktDoneDescIndex[idx]]
+		if ( (*(volatile uint32 *)&txPkthdrRing[idx][done]
 			& DESC_OWNED_BIT) == DESC_RISC_OWNED )
 		{
 
-			pPkthdr = (struct rtl_pktHdr *) ((int32) txPkthdrRing[idx][txPktDoneDescIndex[idx]]
+			pPkthdr = (struct rtl_pktHdr *) ((int32) txPkthdrRing[idx][done]
 				& ~(DESC_OWNED_BIT | DESC_WRAP));
 
 			/* NULL check on hardware-provided pointers */
@@ -915,6 +1120,12 @@ int32 swNic_txDone_stats(int idx, unsigned int *pkts_out, unsigned int *bytes_ou
 			dma_cache_inv((unsigned long)(pPkthdr->ph_mbuf), sizeof(struct rtl_mBuf));
 
 			skb = (struct sk_buff *)pPkthdr->ph_mbuf->skb;
+			trace_rtl819x_tx_done(idx, done, skb, pPkthdr->ph_len);
+#ifdef CONFIG_RTL819X_LATENCY_HIST
+			if (idx == 0 && skb)
+				rtl_lat_hist_add(&rtl_tx_lat_hist,
+						 rtl819x_timer_delta(txEnqueueTicks[done], rtl819x_timer_read()));
+#endif
 			if (skb)
 			{
 				/* Capture stats before freeing SKB */
@@ -923,23 +1134,32 @@ int32 swNic_txDone_stats(int idx, unsigned int *pkts_out, unsigned int *bytes_ou
 					bytes += skb->len;
 				}
 
-				local_irq_restore(flags);
 				dev_kfree_skb_any(skb);
-				local_irq_save(flags);
 				pPkthdr->ph_mbuf->skb = NULL;
 			}
 
+			/* Phase 8: hand chained fragment mbufs back to the pool */
+			if (unlikely(pPkthdr->ph_mbuf->m_next)) {
+				struct rtl_mBuf *m;
+				int frag_done = txFragMbufDone;
 
-			if (++txPktDoneDescIndex[idx] == txPkthdrRingCnt[idx])
-				txPktDoneDescIndex[idx] = 0;
+				for (m = pPkthdr->ph_mbuf->m_next; m; m = m->m_next)
+					if (++frag_done == NUM_TX_FRAG_MBUF)
+						frag_done = 0;
+				pPkthdr->ph_mbuf->m_next = NULL;
+				smp_store_release(&txFragMbufDone, frag_done);
+			}
+
+			if (++done == txPkthdrRingCnt[idx])
+				done = 0;
+			/* Release: skb cleared before the producer may reuse the slot */
+			smp_store_release(&txPktDoneDescIndex[idx], done);
 		}
 		else
 			break;
 		}
 	}
 
-	local_irq_restore(flags);
-
 	/* Return accumulated stats if requested */
 	if (pkts_out) *pkts_out = pkts;
 	if (bytes_out) *bytes_out = bytes;
@@ -959,6 +1179,7 @@ void swNic_freeRxBuf(void)
 		currTxPkthdrDescIndex[i] = 0;
 		txPktDoneDescIndex[i]=0;
 	}
+	txFragMbufCurr = txFragMbufDone = 0;
 
 	for(i=RTL865X_SWNIC_RXRING_HW_PKTDESC-1; i >= 0 ; i--)
 	{
@@ -1051,12 +1272,14 @@ void swNic_freeTxRing(void)
 				dev_kfree_skb_any((struct sk_buff *)pPkthdr->ph_mbuf->skb);
 				pPkthdr->ph_mbuf->skb = NULL;
 			}
+			pPkthdr->ph_mbuf->m_next = NULL;
 			txPkthdrRing[idx][txPktDoneDescIndex[idx]] &= ~DESC_SWCORE_OWNED;
 
 			if (++txPktDoneDescIndex[idx] == txPkthdrRingCnt[idx])
 				txPktDoneDescIndex[idx] = 0;
 			}
 	}
+	txFragMbufCurr = txFragMbufDone = 0;
 
 	local_irq_restore(flags);
 	return ; //free_num;
@@ -1104,6 +1327,7 @@ int32 swNic_reConfigRxTxRing(void)
 		currTxPkthdrDescIndex[i] = 0;
 		txPktDoneDescIndex[i]=0;
 	}
+	txFragMbufCurr = txFragMbufDone = 0;
 
 	/* Fill Tx packet header FDP */
 	REG32(CPUTPDCR0) = (uint32) txPkthdrRing[0];
@@ -1169,9 +1393,6 @@ int32 swNic_init(uint32 userNeedRxPkthdrRingCnt[RTL865X_SWNIC_RXRING_HW_PKTDESC]
                  uint32 clusterSize)
 {
 	uint32 i, j, k;
-	static uint32 totalRxPkthdrRingCnt = 0, totalTxPkthdrRingCnt = 0;
-	static struct rtl_pktHdr *pPkthdrList_start;
-	static struct rtl_mBuf *pMbufList_start;
 	struct rtl_pktHdr *pPkthdrList;
 	struct rtl_mBuf *pMbufList;
 	struct rtl_pktHdr * pPkthdr;
@@ -1301,7 +1522,7 @@ int32 swNic_init(uint32 userNeedRxPkthdrRingCnt[RTL865X_SWNIC_RXRING_HW_PKTDESC]
 
 		/* Allocate mbufs */
 		pMbufList_start = (struct rtl_mBuf *) kmalloc(
-		(rxMbufRingCnt+RESERVERD_MBUF_RING_NUM+totalTxPkthdrRingCnt+1) * sizeof(struct rtl_mBuf), GFP_ATOMIC);
+		(rxMbufRingCnt+RESERVERD_MBUF_RING_NUM+totalTxPkthdrRingCnt+NUM_TX_FRAG_MBUF+1) * sizeof(struct rtl_mBuf), GFP_ATOMIC);
 
 		/* Check allocation success (Issue #8) */
 		if (!pMbufList_start) {
@@ -1366,6 +1587,12 @@ int32 swNic_init(uint32 userNeedRxPkthdrRingCnt[RTL865X_SWNIC_RXRING_HW_PKTDESC]
 
 	}
 
+	/* Phase 8: TX fragment mbuf pool */
+	txFragMbuf = pMbufList;
+	pMbufList += NUM_TX_FRAG_MBUF;
+	bzero((void *) txFragMbuf, NUM_TX_FRAG_MBUF * sizeof(struct rtl_mBuf));
+	txFragMbufCurr = txFragMbufDone = 0;
+
 	/* Fill Tx packet header FDP */
 	REG32(CPUTPDCR0) = (uint32) txPkthdrRing[0];
 	REG32(CPUTPDCR1) = (uint32) txPkthdrRing[1];
@@ -1447,30 +1674,57 @@ int32 swNic_init(uint32 userNeedRxPkthdrRingCnt[RTL865X_SWNIC_RXRING_HW_PKTDESC]
 cleanup_partial_init:
 	/* Cleanup partially allocated resources (Issue #8) */
 	printk(KERN_ERR "rtl819x_swnic: Cleaning up partial initialization\n");
+	swNic_freeRings();
+
+out:
+
+	if (ret == SUCCESS && pPkthdrList_start && pMbufList_start) {
+		dma_cache_wback_inv((unsigned long)pPkthdrList_start, (totalRxPkthdrRingCnt + totalTxPkthdrRingCnt) * sizeof(struct rtl_pktHdr));
+		dma_cache_wback_inv((unsigned long)pMbufList_start, (rxMbufRingCnt+RESERVERD_MBUF_RING_NUM+ totalTxPkthdrRingCnt+NUM_TX_FRAG_MBUF) * sizeof(struct rtl_mBuf));
+	}
+
+	//local_irq_restore(flags);
+	return ret;
+}
+
+/**
+ * swNic_freeRings - Release all descriptor rings and pkthdr/mbuf pools
+ *
+ * Phase 8: Used on swNic_init() failure and to resize the rings (ethtool -G).
+ * The switch core must be stopped, RX buffers released (swNic_freeRxBuf())
+ * and the TX ring drained (swNic_freeTxRing()) by the caller. The next
+ * swNic_init() then allocates the rings with the sizes it is given.
+ */
+void swNic_freeRings(void)
+{
+	int i;
 
 	/* Free RX descriptor rings */
 	for (i = 0; i < RTL865X_SWNIC_RXRING_HW_PKTDESC; i++) {
 		if (rxPkthdrRing[i]) {
-			kfree(rxPkthdrRing[i]);
+			UNCACHED_FREE(rxPkthdrRing[i]);
 			rxPkthdrRing[i] = NULL;
 		}
+		rxPkthdrRingCnt[i] = 0;
 	}
 
 	/* Free TX descriptor rings */
 	for (i = 0; i < RTL865X_SWNIC_TXRING_HW_PKTDESC; i++) {
 		if (txPkthdrRing[i]) {
-			kfree(txPkthdrRing[i]);
+			UNCACHED_FREE(txPkthdrRing[i]);
 			txPkthdrRing[i] = NULL;
 		}
+		txPkthdrRingCnt[i] = 0;
 	}
 
 	/* Free mbuf ring */
 	if (rxMbufRing) {
-		kfree(rxMbufRing);
+		UNCACHED_FREE(rxMbufRing);
 		rxMbufRing = NULL;
 	}
+	rxMbufRingCnt = 0;
 
-	/* Free pkthdr list */
+	/* Free pkthdr list (cached, see swNic_init()) */
 	if (pPkthdrList_start) {
 		kfree(pPkthdrList_start);
 		pPkthdrList_start = NULL;
@@ -1482,15 +1736,26 @@ cleanup_partial_init:
 		pMbufList_start = NULL;
 	}
 
-out:
+	totalRxPkthdrRingCnt = totalTxPkthdrRingCnt = 0;
+}
 
-	if (ret == SUCCESS && pPkthdrList_start && pMbufList_start) {
-		dma_cache_wback_inv((unsigned long)pPkthdrList_start, (totalRxPkthdrRingCnt + totalTxPkthdrRingCnt) * sizeof(struct rtl_pktHdr));
-		dma_cache_wback_inv((unsigned long)pMbufList_start, (rxMbufRingCnt+RESERVERD_MBUF_RING_NUM+ totalTxPkthdrRingCnt) * sizeof(struct rtl_mBuf));
-	}
+/**
+ * swNic_memFootprint - Memory held by the rings and descriptor pools
+ *
+ * Return: bytes of descriptor rings, pkthdrs and mbufs (RX buffers excluded)
+ */
+uint32 swNic_memFootprint(void)
+{
+	uint32 mbufs;
 
-	//local_irq_restore(flags);
-	return ret;
+	if (rxMbufRing == NULL)
+		return 0;
+
+	mbufs = rxMbufRingCnt + RESERVERD_MBUF_RING_NUM + totalTxPkthdrRingCnt + NUM_TX_FRAG_MBUF + 1;
+	return (totalRxPkthdrRingCnt + totalTxPkthdrRingCnt) * sizeof(uint32) +
+	       (rxMbufRingCnt + RESERVERD_MBUF_RING_NUM) * sizeof(uint32) +
+	       (totalRxPkthdrRingCnt + totalTxPkthdrRingCnt + 1) * sizeof(struct rtl_pktHdr) +
+	       mbufs * sizeof(struct rtl_mBuf);
 }
 
 int32 rtl_check_tx_done_desc_swCore_own(int32 *tx_done_inx)
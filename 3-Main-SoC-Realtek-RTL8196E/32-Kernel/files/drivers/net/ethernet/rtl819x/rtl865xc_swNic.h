@@ -48,24 +48,44 @@
 	#endif
 	#define NUM_TX_PKTHDR_DESC			600  /* Was 400, now 600 for better TX throughput */	
 
-#define	RTL865X_SWNIC_RXRING_MAX_PKTDESC    1
+/* Phase 8: The values above are boot defaults. Ring 0 sizes can be changed
+ * with module parameters or ethtool -G within these bounds.
+ */
+#define	NUM_RX_PKTHDR_DESC_MIN		64
+#define	NUM_RX_PKTHDR_DESC_MAX		1024
+#define	NUM_TX_PKTHDR_DESC_MIN		64
+#define	NUM_TX_PKTHDR_DESC_MAX		1024
+
+/* Phase 8: Scatter-gather TX. Each skb page fragment gets an mbuf from a
+ * shared pool, chained (m_next) behind the pkthdr's own mbuf. Packets with
+ * more fragments than RTL865X_SWNIC_TX_MAX_FRAGS are linearized by the caller.
+ */
+#define	NUM_TX_FRAG_MBUF			128
+#define	RTL865X_SWNIC_TX_MAX_FRAGS		8
+
+/* Phase 8: Priority RX ring. The CPU port runs two output queues; QID1
+ * (fed by the ACL priority rule, see rtl_prio_rx_setup()) lands in RX
+ * ring 1, which swNic_receive() drains before bulk ring 0.
+ */
+#define	RTL865X_SWNIC_RXRING_MAX_PKTDESC    2
 #define	RTL865X_SWNIC_TXRING_MAX_PKTDESC    1
-#define	RTL_CPU_RX_RING_NUM			1
-#define	NUM_RX_PKTHDR_DESC1		2
+#define	RTL_CPU_RX_RING_NUM			2
+#define	RTL_PRIO_RX_RING			1
+#define	NUM_RX_PKTHDR_DESC1		64
 #define	NUM_RX_PKTHDR_DESC2		2
 #define	NUM_RX_PKTHDR_DESC3		2
 #define	NUM_RX_PKTHDR_DESC4		2
 #define	NUM_RX_PKTHDR_DESC5		2
 #define	NUM_TX_PKTHDR_DESC1		2
 
-#define	ETH_REFILL_THRESHOLD1	0	// must < NUM_RX_PKTHDR_DESC
+#define	ETH_REFILL_THRESHOLD1	4	// must < NUM_RX_PKTHDR_DESC1
 #define	ETH_REFILL_THRESHOLD2	0	// must < NUM_RX_PKTHDR_DESC
 #define	ETH_REFILL_THRESHOLD3	0	// must < NUM_RX_PKTHDR_DESC
 #define	ETH_REFILL_THRESHOLD4	0	// must < NUM_RX_PKTHDR_DESC
 #define	ETH_REFILL_THRESHOLD5	0	// must < NUM_RX_PKTHDR_DESC
 
 #define	QUEUEID0_RXRING_MAPPING		0
-#define	QUEUEID1_RXRING_MAPPING		0
+#define	QUEUEID1_RXRING_MAPPING		RTL_PRIO_RX_RING
 #define	QUEUEID2_RXRING_MAPPING		0
 #define	QUEUEID3_RXRING_MAPPING		0
 #define	QUEUEID4_RXRING_MAPPING		0
@@ -88,6 +108,8 @@ typedef struct {
 	uint16			len;
 	uint16			priority:3;
 	uint16			rxPri:3;
+	uint16			vlanTagged:1;
+	uint8			tos;		/* original IPv4 TOS (ph_orgtos) */
 	void* 			input;
 	struct dev_priv*	priv;
 	uint32			isPdev;
@@ -100,7 +122,9 @@ typedef struct {
 	uint16		portlist;
 	uint16		srcExtPort;
 	uint16		flags;
+	uint16		vlanTagPorts;	/* ports on which the ASIC inserts an 802.1Q tag */
 	uint32		txIdx:1;
+	uint32		priority:3;	/* ph_txPriority, PCP of an inserted tag */
 	void 			*out_skb;
 }	rtl_nicTx_info;
 
@@ -147,6 +171,19 @@ int32 swNic_txRingFreeCount(int idx);  /* Check TX ring free space for flow cont
 int32 swNic_txDone(int idx);
 int32 swNic_txDone_stats(int idx, unsigned int *pkts_out, unsigned int *bytes_out);  /* TX done with BQL stats */
 void swNic_freeRxBuf(void);
+void swNic_freeRings(void);  /* Release rings and pools; next swNic_init() reallocates */
+uint32 swNic_memFootprint(void);  /* Bytes held by rings, pkthdrs and mbufs */
+
+/* Phase 8: RX trap reason histogram (raw ph_reason values, first seen first) */
+#define RTL_RX_REASON_SLOTS	16
+
+struct rtl_rx_reason_slot {
+	uint16		reason;
+	unsigned long	count;
+};
+
+int rtl_swnic_get_rx_reasons(struct rtl_rx_reason_slot *slots, unsigned long *other);
+unsigned long rtl_swnic_get_rx_csum_drops(void);
 int swNic_refillRxRing(void);  /* Refill RX descriptors from rx_skb_queue */
 int32	swNic_txRunout(void);
 extern	uint32* rxMbufRing;
@@ -206,9 +243,43 @@ struct ring_que {
 	struct sk_buff **ring;
 };
 
+/*
+ * Allocate a DMA-shared object and return its KSEG1 (uncached) alias.
+ * The cached alias is written back and invalidated first so that no
+ * dirty line can later be evicted over what the switch core wrote.
+ */
 static inline void *UNCACHED_MALLOC(int size)
 {
-	return ((void *)(((uint32)kmalloc(size, GFP_ATOMIC)) | UNCACHE_MASK));
+	void *p = kmalloc(size, GFP_ATOMIC);
+
+	if (!p)
+		return NULL;
+	dma_cache_wback_inv((unsigned long)p, size);
+	return ((void *)(((uint32)p) | UNCACHE_MASK));
+}
+
+static inline void UNCACHED_FREE(void *p)
+{
+	if (p)
+		kfree((void *)(((uint32)p) & ~UNCACHE_MASK));
 }
 
+#ifdef CONFIG_RTL819X_LATENCY_HIST
+#include <asm/mach-realtek/realtek_timer.h>
+
+/* Phase 8: Per-packet latency histograms (debugfs rtl819x/{rx,tx}_latency) */
+#define RTL_LAT_HIST_BUCKETS	16	/* log2(us): <1 us ... >=16 ms */
+
+struct rtl_lat_hist {
+	u32 bucket[RTL_LAT_HIST_BUCKETS];
+	u32 count;
+	u32 max_ns;
+	u64 sum_ns;
+};
+
+extern struct rtl_lat_hist rtl_rx_lat_hist;
+extern struct rtl_lat_hist rtl_tx_lat_hist;
+void rtl_lat_hist_add(struct rtl_lat_hist *h, u32 ticks);
+#endif
+
 #endif /* _SWNIC_H */
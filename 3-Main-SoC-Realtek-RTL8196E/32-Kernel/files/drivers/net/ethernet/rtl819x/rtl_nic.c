@@ -23,6 +23,14 @@
  *   - NAPI polling (replaced tasklet RX/TX)
  *   - Device Tree integration (platform_driver)
  *   - 64-bit statistics, ethtool support, BQL
+ *   - Adaptive RX interrupt moderation (ethtool -C rx-usecs/rx-frames)
+ *   - 802.1Q tag offload (VID from/to the packet header, ethtool -K rxvlan/txvlan)
+ *   - Scatter-gather TX (chained mbufs) and IPv4 TX checksum offload
+ *   - Priority RX ring for an ACL-classified TCP/UDP port (DT priority-rx-port)
+ *   - Per-port ingress/egress rate limiting in the switch (DT, tc police)
+ *   - Cached 64-bit MIB counter snapshot, refreshed in the background
+ *   - Ring 0 and SKB pool sizing at load time or with ethtool -G
+ *   - RX flow hash, skb->priority from the ASIC/802.1p/TOS, trap reason counters
  *   - Security fixes (spinlocks, atomic ops, input validation)
  *
  * SPDX-License-Identifier: GPL-2.0
@@ -39,20 +47,39 @@
 #define RTL_NIC_TX_STOP_THRESHOLD  16  /* Stop queue when < 16 free */
 #define RTL_NIC_TX_WAKE_THRESHOLD  64  /* Wake queue when > 64 free */
 
+/* RX interrupt moderation defaults (tunable with ethtool -C rx-usecs/rx-frames) */
+#define RTL_NIC_RX_COAL_USECS      100    /* Hold-off before re-polling under load */
+#define RTL_NIC_RX_COAL_FRAMES     8      /* Poll batch size considered "under load" */
+#define RTL_NIC_RX_FRAME_NS        6720   /* 64-byte frame + preamble + IFG at 100 Mbps */
+
 #include <linux/if_vlan.h>
 #include <linux/proc_fs.h>
 #include <linux/ethtool.h>
+#include <linux/hrtimer.h>
+#include <linux/debugfs.h>
+#include <linux/seq_file.h>
+#include <linux/ip.h>
+#include <linux/jhash.h>
+#include <linux/random.h>
 #include <linux/kernel.h>  /* for vprintk() and va_list */
 #include <asm/io.h>  /* for dma_cache_wback_inv() - Kernel 5.4: moved from cacheflush.h to io.h */
 #include <linux/platform_device.h>  /* DT integration: platform_driver support */
 #include <linux/of.h>               /* DT integration: device tree parsing */
 #include <linux/of_platform.h>      /* DT integration: of_match_table */
+#include <asm/mach-realtek/realtek_irq.h>  /* IRQ fast path latency */
 #include "rtl819x.h"
 #include "AsicDriver/rtl865x_asicCom.h"
 #include "AsicDriver/rtl865x_asicL2.h"
 #include "rtl865xc_swNic.h"
 #include "common/rtl865x_vlan.h"  /* For VLAN functions */
 #include "common/rtl865x_eventMgr.h"  /* For event manager */
+#if IS_ENABLED(CONFIG_NET_CLS_MATCHALL) && IS_ENABLED(CONFIG_NET_ACT_POLICE)
+#define RTL819X_TC_POLICE_OFFLOAD
+#include <net/pkt_cls.h>              /* matchall/police offload */
+#endif
+
+#define CREATE_TRACE_POINTS
+#include "rtl819x_trace.h"            /* Hot-path tracepoints */
 
 /* RTL865xC ASIC regs: local-only defines (trimmed from rtl865xc_asicregs.h) */
 #define MAX_PORT_NUMBER 6
@@ -137,8 +164,12 @@
 
 
 /* Local driver definitions (formerly in include/rtl_nic.h) */
-#define MAX_ETH_SKB_NUM ( \
-	NUM_RX_PKTHDR_DESC + NUM_RX_PKTHDR_DESC1 + NUM_RX_PKTHDR_DESC2 + NUM_RX_PKTHDR_DESC3 + NUM_RX_PKTHDR_DESC4 + NUM_RX_PKTHDR_DESC5 + MAX_PRE_ALLOC_RX_SKB + 690)
+/* Phase 8: The SKB pool is sized at runtime from the RX rings and the
+ * pre-allocation queue, plus this many buffers in flight in the stack.
+ */
+#define RTL_ETH_SKB_INFLIGHT 690
+#define RTL_ETH_POOL_LOW_WATER 64	/* below this, priv_skb_copy() copies out */
+#define RTL_ETH_POOL_ORDER 3	/* 32 KB chunks, 15 buffers each */
 /* Kernel 5.4: NET_SKB_PAD uses max() which is braced-group, can't use in array declaration
  * On MIPS, L1_CACHE_BYTES=32, so NET_SKB_PAD=32. Use constant instead. */
 #define ETH_SKB_BUF_SIZE 2048
@@ -198,6 +229,12 @@ struct dev_priv
 	unsigned long rx_refill_failures;       /* refill_rx_skb() allocation failures */
 	unsigned long rx_pool_empty_events;     /* Times eth_skb_free_num == 0 */
 	int last_eth_skb_free_num;             /* Snapshot of buffer pool size */
+
+	/* Phase 8: Adaptive RX interrupt moderation (ethtool -C) */
+	struct hrtimer coal_timer;              /* Re-poll after hold-off, IRQs masked */
+	u32 rx_coalesce_usecs;                  /* Hold-off length, 0 = disabled */
+	u32 rx_max_coalesced_frames;            /* Batch size that triggers hold-off */
+	unsigned long rx_coal_holdoffs;         /* Number of hold-offs armed */
 };
 
 typedef struct __rtlInterruptRxData
@@ -235,6 +272,32 @@ struct port_statistics
 	unsigned int tx_error;
 };
 
+/*
+ * Phase 8: MIB snapshot. The 32-bit ASIC counters of every port are read
+ * in one pass by a background worker and accumulated into 64-bit totals;
+ * ethtool, get_stats64, the port-stats ioctl and debugfs only copy them.
+ */
+struct rtl_mib_port
+{
+	u64 rx_bytes;
+	u64 rx_unipkts;
+	u64 rx_mulpkts;
+	u64 rx_bropkts;
+	u64 rx_discard;
+	u64 rx_fcs_errors;
+	u64 rx_jabbers;
+	u64 tx_bytes;
+	u64 tx_unipkts;
+	u64 tx_mulpkts;
+	u64 tx_bropkts;
+	u64 tx_discard;
+	u64 tx_collisions;
+	u64 tx_deferred;
+};
+
+static void rtl_mib_sum_ports(u32 portmask, struct rtl_mib_port *sum,
+			      unsigned long *stamp);
+
 #define RTL_PS_BR0_DEV_NAME RTL_BR_NAME
 #define RTL_PS_ETH_NAME "eth"
 #define RTL_PS_WLAN_NAME RTL_WLAN_NAME
@@ -314,46 +377,19 @@ int panic_printk(const char *fmt, ...)
 EXPORT_SYMBOL(panic_printk);
 
 /* Kernel 5.4 migration: Stub for optional features */
-static inline void rtl865x_LinkChange_Process(void) { /* Stub: link change processing disabled */ }
 static inline void rtl865x_config_callback_for_get_drv_netifName(void *cb) { /* Stub: callback disabled */ }
 
-/**
- * rtl_skb_dma_cache_wback_inv - Flush DMA cache for TX SKB
- * @skb: Socket buffer to flush
- *
- * Flushes the SKB data cache before DMA transmission to ensure hardware
- * sees the correct data.
- *
- * NOTE: Scatter-gather NOT supported by this driver
- * ====================================================
- * This driver does NOT set NETIF_F_SG in dev->features, so the Linux
- * network stack automatically linearizes all SKBs before passing them
- * to us. This means nr_frags is ALWAYS 0, and we only need to flush
- * the linear data portion.
- *
- * If scatter-gather support is added in future:
- * 1. Set dev->features |= NETIF_F_SG during device initialization
- * 2. Add fragment flushing loop here (see git history for reference)
- * 3. Test with large packets: iperf -c <host> -l 9000
- *
- * See SCATTER_GATHER_ANALYSIS.md for full details.
- *
- * Kernel 5.4 migration: Use dma_cache_wback_inv from asm/io.h
- */
-void rtl_skb_dma_cache_wback_inv(struct sk_buff *skb)
-{
-	if (unlikely(!skb))
-		return;
-
-	/* Flush linear data portion (this is all we ever receive) */
-	if (skb->len > 0 && skb->data) {
-		dma_cache_wback_inv((unsigned long)skb->data, skb_headlen(skb));
-	}
-}
-
 static unsigned int curLinkPortMask = 0;
 static unsigned int newLinkPortMask = 0;
 
+/*
+ * Phase 8: link changes are handled from the LINK_CHANGE_IP interrupt.
+ * one_sec_timer() only re-checks the port status and the switch core
+ * every RTL_LINK_WATCHDOG_PERIOD seconds, in case an interrupt was lost.
+ */
+#define RTL_LINK_WATCHDOG_PERIOD 5
+static unsigned int rtl_link_watchdog_tick = 0;
+
 #define SET_MODULE_OWNER(dev) \
 	do                        \
 	{                         \
@@ -382,6 +418,9 @@ static void one_sec_timer(struct timer_list *t);
 
 static struct sk_buff *dev_alloc_skb_priv_eth(unsigned int size);
 static void init_priv_eth_skb_buf(void);
+static unsigned int rtl_eth_pool_needed(void);
+static int rtl_eth_pool_grow(unsigned int target);
+static void rtl_eth_pool_shrink(unsigned int target);
 
 /* Switch core management functions */
 int rtl865x_reinitSwitchCore(void);
@@ -391,6 +430,13 @@ int skb_num = 0;
 
 int32 rtl865x_init(void);
 int32 rtl865x_config(struct rtl865x_vlanConfig vlanconfig[]);
+static int32 rtl_prio_rx_setup(struct rtl865x_vlanConfig vlanconfig[]);
+static void rtl_port_rate_store(u32 portmask, bool ingress, u32 kbps);
+static void rtl_port_rate_apply(void);
+#ifdef RTL819X_TC_POLICE_OFFLOAD
+static int rtl819x_setup_tc(struct net_device *dev, enum tc_setup_type type,
+			    void *type_data);
+#endif
 
 /* These identify the driver base version and may not be removed. */
 MODULE_DESCRIPTION("RealTek RTL-8650 series 10/100 Ethernet driver");
@@ -400,6 +446,21 @@ MODULE_LICENSE("GPL");
 static char *multicast_filter_limit = "maximum number of filtered multicast addresses";
 module_param(multicast_filter_limit, charp, S_IRUGO);
 
+/* Phase 8: Ring 0 and pre-allocation sizing (boot values, see ethtool -G) */
+static int rtl_rx_ring_size = NUM_RX_PKTHDR_DESC;
+module_param(rtl_rx_ring_size, int, S_IRUGO);
+MODULE_PARM_DESC(rtl_rx_ring_size, "RX ring 0 descriptors (64-1024)");
+
+static int rtl_tx_ring_size = NUM_TX_PKTHDR_DESC;
+module_param(rtl_tx_ring_size, int, S_IRUGO);
+MODULE_PARM_DESC(rtl_tx_ring_size, "TX ring 0 descriptors (64-1024)");
+
+static int rtl_rx_prealloc = MAX_PRE_ALLOC_RX_SKB;
+module_param(rtl_rx_prealloc, int, S_IRUGO);
+MODULE_PARM_DESC(rtl_rx_prealloc, "Pre-allocated RX SKBs (0-1024)");
+
+static bool rtl_mem_report_pending = true;
+
 #define PFX DRV_NAME ": "
 #define TX_TIMEOUT (10 * HZ)
 #define BDINFO_ADDR 0xbe3fc000
@@ -420,6 +481,13 @@ int cnt_swcore_rx = 0;
 int cnt_swcore_link = 0;
 int cnt_swcore_err = 0;
 
+#ifdef CONFIG_RTL819X_LATENCY_HIST
+/* Phase 8: SoC timer stamp of the event that started the current NAPI cycle
+ * (RX IRQ or hold-off expiry), for the RX-IRQ-to-GRO histogram.
+ */
+static u32 rtl_rx_irq_ticks;
+#endif
+
 /* Link change interrupt handling (still uses tasklet, not NAPI) */
 static inline void rtl_link_change_interrupt_process(unsigned int status, struct dev_priv *cp);
 
@@ -509,6 +577,24 @@ static struct rtl865x_vlanConfig vlanconfig[] = {
 	RTL865X_CONFIG_END,
 };
 
+/*
+ * Phase 8: Destination TCP/UDP port steered to the priority RX ring
+ * (radio bridge, serialgateway default). Overridden by the DT property
+ * "priority-rx-port"; 0 disables the ACL rule.
+ */
+#define RTL_PRIO_RX_PORT 8888
+static u32 rtl_prio_rx_port = RTL_PRIO_RX_PORT;
+
+/*
+ * Phase 8: Per-PHY-port bandwidth limits in kbps, 0 = line rate.
+ * Set from the DT ("ingress-rate-kbps"/"egress-rate-kbps") or by a tc
+ * matchall police rule, re-applied after every ASIC reset. Limits at or
+ * above the Fast Ethernet line rate mean no limit.
+ */
+#define RTL_PORT_RATE_MAX_KBPS	100000
+static u32 rtl_port_ingress_kbps[RTL8651_PHY_NUMBER];
+static u32 rtl_port_egress_kbps[RTL8651_PHY_NUMBER];
+
 /*	The following structure's field orders was arranged for special purpose,
 	it should NOT be modify	*/
 struct priv_skb_buf2
@@ -520,7 +606,24 @@ struct priv_skb_buf2
 	unsigned char buf[ETH_SKB_BUF_SIZE];
 };
 
-static struct priv_skb_buf2 eth_skb_buf[MAX_ETH_SKB_NUM + 1];
+/* Phase 8: Pool buffers live in page chunks so the pool can grow when the
+ * rings are enlarged. A chunk is only freed once all its buffers are back
+ * in the free list: buffers are identified by magic/buf_pointer and may
+ * still be held by the stack.
+ */
+struct rtl_eth_pool_chunk
+{
+	struct list_head list;
+	struct priv_skb_buf2 buf[];
+};
+
+#define RTL_ETH_POOL_CHUNK_BUFS \
+	(((PAGE_SIZE << RTL_ETH_POOL_ORDER) - sizeof(struct rtl_eth_pool_chunk)) / \
+	 sizeof(struct priv_skb_buf2))
+
+static LIST_HEAD(eth_pool_chunks);
+static unsigned int eth_pool_chunk_cnt;
+static unsigned int eth_skb_total_num;
 static struct list_head eth_skbbuf_list;
 int eth_skb_free_num;
 EXPORT_SYMBOL(eth_skb_free_num);
@@ -743,26 +846,30 @@ static void re865x_get_stats64(struct net_device *dev,
 {
 	struct dev_priv *dp = netdev_priv(dev);
 	struct net_device_stats *ns = &dp->net_stats;
+	struct rtl_mib_port mib;
+
+	/* Phase 8: port error counters from the cached MIB snapshot */
+	rtl_mib_sum_ports(dp->portmask, &mib, NULL);
 
 	/* Copy standard statistics to 64-bit structure */
 	stats->rx_packets = ns->rx_packets;
 	stats->tx_packets = ns->tx_packets;
 	stats->rx_bytes = ns->rx_bytes;
 	stats->tx_bytes = ns->tx_bytes;
-	stats->rx_errors = ns->rx_errors;
+	stats->rx_errors = ns->rx_errors + mib.rx_fcs_errors + mib.rx_jabbers;
 	stats->tx_errors = ns->tx_errors;
 	stats->rx_dropped = ns->rx_dropped;
 	stats->tx_dropped = ns->tx_dropped;
 	stats->multicast = ns->multicast;
-	stats->collisions = ns->collisions;
+	stats->collisions = ns->collisions + mib.tx_collisions;
 
 	/* Detailed RX error statistics */
-	stats->rx_length_errors = ns->rx_length_errors;
+	stats->rx_length_errors = ns->rx_length_errors + mib.rx_jabbers;
 	stats->rx_over_errors = ns->rx_over_errors;
-	stats->rx_crc_errors = ns->rx_crc_errors;
+	stats->rx_crc_errors = ns->rx_crc_errors + mib.rx_fcs_errors;
 	stats->rx_frame_errors = ns->rx_frame_errors;
 	stats->rx_fifo_errors = ns->rx_fifo_errors;
-	stats->rx_missed_errors = ns->rx_missed_errors;
+	stats->rx_missed_errors = ns->rx_missed_errors + mib.rx_discard;
 
 	/* Detailed TX error statistics */
 	stats->tx_aborted_errors = ns->tx_aborted_errors;
@@ -1165,6 +1272,36 @@ static inline void rtl_processRxFrame(rtl_nicRx_info *info)
 
 rtlInterruptRxData RxIntData;
 
+static u32 rtl_rx_hash_seed __read_mostly;
+
+/**
+ * rtl_rx_set_hash - Fill skb->hash for IPv4 TCP/UDP frames
+ * @skb: Received frame, skb->data at the network header
+ *
+ * Phase 8: The pkthdr carries no flow hash, but the ALE has already
+ * validated the IP and L4 headers (bad ones are dropped in swNic_receive()),
+ * so hashing the 4-tuple is a handful of loads. This spares the flow
+ * dissector on the egress qdisc for bridged/forwarded traffic and spreads
+ * flows over the GRO hash buckets.
+ */
+static inline void rtl_rx_set_hash(struct sk_buff *skb)
+{
+	const struct iphdr *iph = (const struct iphdr *)skb->data;
+	u32 ports;
+
+	if (skb->protocol != htons(ETH_P_IP) || skb->len < sizeof(struct iphdr))
+		return;
+	if (iph->ihl < 5 || ip_is_fragment(iph) ||
+	    (iph->protocol != IPPROTO_TCP && iph->protocol != IPPROTO_UDP) ||
+	    skb->len < (iph->ihl << 2) + sizeof(ports))
+		return;
+
+	ports = *(const u32 *)(skb->data + (iph->ihl << 2));
+	skb_set_hash(skb, jhash_3words((__force u32)iph->saddr, (__force u32)iph->daddr,
+				       ports ^ iph->protocol, rtl_rx_hash_seed),
+		     PKT_HASH_TYPE_L4);
+}
+
 /* ============================================================================
  * Phase 2: NAPI Polling Functions (v3.5.0)
  * ============================================================================ */
@@ -1206,6 +1343,48 @@ static void rtl819x_poll_tx(struct dev_priv *cp)
 	}
 }
 
+/**
+ * rtl819x_enable_napi_irq - Re-enable RX/TX interrupts after a NAPI cycle
+ *
+ * Counterpart of the masking done in interrupt_isr_napi().
+ */
+static void rtl819x_enable_napi_irq(void)
+{
+	unsigned long flags;
+
+	local_irq_save(flags);
+
+	/*
+	 * CRITICAL: Clear pending runout interrupts before re-enabling.
+	 *
+	 * Without clearing the interrupt flag here, if descriptors are still low
+	 * when we re-enable interrupts, we immediately get another runout interrupt,
+	 * creating an interrupt storm (3+ million ERR interrupts, 99%+ packet loss).
+	 */
+	REG32(CPUIISR) = (PKTHDR_DESC_RUNOUT_IP_ALL | MBUF_DESC_RUNOUT_IP_ALL);
+
+	/* Re-enable RX and TX interrupts */
+	rtl_rxSetTxDone(TRUE);
+	REG32(CPUIIMR) |= (RX_DONE_IE_ALL | PKTHDR_DESC_RUNOUT_IE_ALL | TX_ALL_DONE_IE_ALL);
+
+	local_irq_restore(flags);
+}
+
+/**
+ * rtl819x_coal_holdoff_ok - Can coal_timer honour rx-usecs?
+ * @cp: Device private data
+ *
+ * Without CONFIG_HIGH_RES_TIMERS (or before the kernel has switched to
+ * high resolution mode), hrtimer_resolution is one jiffy, 4 ms at HZ=250,
+ * and a 100 us hold-off would really last 4 ms. Unmask immediately
+ * instead, as with rx-usecs 0.
+ */
+static inline bool rtl819x_coal_holdoff_ok(const struct dev_priv *cp)
+{
+	return cp->rx_coalesce_usecs &&
+	       (u64)cp->rx_coalesce_usecs * NSEC_PER_USEC >= hrtimer_resolution;
+}
+
 /**
  * rtl819x_poll - NAPI poll function
  * @napi: NAPI structure
@@ -1248,8 +1427,11 @@ static int rtl819x_poll(struct napi_struct *napi, int budget)
 			if (SUCCESS == decide_ret) {
 				struct dev_priv *cp_this = info.priv;
 				struct sk_buff *skb = info.input;
-				uint32 vid, len;
+				uint32 len;
+				uint16 tci;
+				int tagged, vlan_hw;
 				uint8 *data;
+				uint32 prio = info.priority;
 
 				/* Sanity check */
 				if (skb->head == NULL || skb->end == NULL) {
@@ -1264,13 +1446,35 @@ static int rtl819x_poll(struct napi_struct *napi, int budget)
 				skb_put(skb, len);
 				skb->dev = cp_this->dev;
 
-				/* VLAN processing (strip VLAN tag if present) */
-				if (skb->len >= 16 &&
-				    *((uint16 *)(skb->data + (ETH_ALEN << 1))) == __constant_htons(ETH_P_8021Q)) {
-					vid = *((unsigned short *)(data + (ETH_ALEN << 1) + 2));
-					vid &= 0x0fff;
-					memmove(data + VLAN_HLEN, data, ETH_ALEN << 1);
-					skb_pull(skb, VLAN_HLEN);
+				/* Phase 8: VLAN RX offload. The ALE already classified the
+				 * frame: ph_vlanId carries the VID and ph_vlanTagged tells
+				 * whether the tag survived egress to the CPU. Frames on
+				 * untag-ports (the DT default) are therefore never parsed
+				 * nor moved.
+				 *  - native VID: a kept tag is always stripped, the frame
+				 *    reaches this netdev untagged as before Phase 8;
+				 *  - other VIDs, CTAG_RX on: the tag goes to vlan_tci;
+				 *  - other VIDs, CTAG_RX off: the frame is left as the ALE
+				 *    delivered it, a kept tag is removed by the core's
+				 *    software untagging (skb_vlan_untag()).
+				 */
+				tci = info.vid;
+				tagged = 0;
+				if (unlikely(info.vlanTagged) && skb->len >= VLAN_ETH_HLEN &&
+				    *((uint16 *)(data + (ETH_ALEN << 1))) == __constant_htons(ETH_P_8021Q)) {
+					tci = ntohs(*((__be16 *)(data + (ETH_ALEN << 1) + 2)));
+					tagged = 1;
+					if (!prio)
+						prio = tci >> VLAN_PRIO_SHIFT;
+				}
+				vlan_hw = (tci & VLAN_VID_MASK) != cp_this->id;
+				if (!vlan_hw || (skb->dev->features & NETIF_F_HW_VLAN_CTAG_RX)) {
+					if (tagged) {
+						memmove(data + VLAN_HLEN, data, ETH_ALEN << 1);
+						skb_pull(skb, VLAN_HLEN);
+					}
+					if (vlan_hw)
+						__vlan_hwaccel_put_tag(skb, htons(ETH_P_8021Q), tci);
 				}
 
 				/* Update statistics */
@@ -1280,6 +1484,21 @@ static int rtl819x_poll(struct napi_struct *napi, int budget)
 				/* Submit to stack with GRO */
 				skb->protocol = eth_type_trans(skb, skb->dev);
 				skb->ip_summed = CHECKSUM_UNNECESSARY;
+
+				/* Phase 8: The ASIC decision (port/ACL, e.g. the priority
+				 * RX port) wins, then the 802.1p bits of a kept tag, then
+				 * the IP precedence of the original TOS.
+				 */
+				if (!prio && skb->protocol == htons(ETH_P_IP))
+					prio = info.tos >> 5;
+				skb->priority = prio;
+				if (skb->dev->features & NETIF_F_RXHASH)
+					rtl_rx_set_hash(skb);
+				trace_rtl819x_rx_skb(skb, info.vid);
+#ifdef CONFIG_RTL819X_LATENCY_HIST
+				rtl_lat_hist_add(&rtl_rx_lat_hist,
+						 rtl819x_timer_delta(rtl_rx_irq_ticks, rtl819x_timer_read()));
+#endif
 				napi_gro_receive(napi, skb);
 
 				work_done++;
@@ -1305,32 +1524,62 @@ poll_done:
 	if (likely(!atomic_read(&rtl_driver_shutting_down)))
 		rtl819x_poll_tx(cp);
 
-	/* If we processed less than budget, we're done - re-enable interrupts */
+	/* If we processed less than budget, we're done.
+	 *
+	 * Phase 8: Adaptive moderation. A sparse poll (Zigbee bridge, ARP,
+	 * SSH keystrokes) re-enables interrupts immediately so latency stays
+	 * at one IRQ. A poll that harvested at least rx-frames packets means
+	 * the link is busy: complete NAPI but keep RX/TX interrupts masked and
+	 * re-poll from coal_timer after rx-usecs. Under sustained load the
+	 * driver then runs one poll per hold-off instead of one IRQ per burst.
+	 *
+	 * The hold-off needs high resolution timers, see
+	 * rtl819x_coal_holdoff_ok().
+	 *
+	 * napi_complete_done() returns false when the core defers the unmask
+	 * itself (napi_defer_hard_irqs + gro_flush_timeout in sysfs, or busy
+	 * polling); interrupts must then stay masked in both branches.
+	 */
 	if (work_done < budget) {
-		if (napi_complete_done(napi, work_done)) {
-			unsigned long flags;
-			local_irq_save(flags);
-
-			/*
-			 * CRITICAL: Clear pending runout interrupts before re-enabling.
-			 *
-			 * Without clearing the interrupt flag here, if descriptors are still low
-			 * when we re-enable interrupts, we immediately get another runout interrupt,
-			 * creating an interrupt storm (3+ million ERR interrupts, 99%+ packet loss).
-			 */
-			REG32(CPUIISR) = (PKTHDR_DESC_RUNOUT_IP_ALL | MBUF_DESC_RUNOUT_IP_ALL);
-
-			/* Re-enable RX and TX interrupts */
-			rtl_rxSetTxDone(TRUE);
-			REG32(CPUIIMR) |= (RX_DONE_IE_ALL | PKTHDR_DESC_RUNOUT_IE_ALL | TX_ALL_DONE_IE_ALL);
-
-			local_irq_restore(flags);
+		if (rtl819x_coal_holdoff_ok(cp) &&
+		    work_done >= cp->rx_max_coalesced_frames &&
+		    likely(!atomic_read(&rtl_driver_shutting_down))) {
+			if (napi_complete_done(napi, work_done)) {
+				cp->rx_coal_holdoffs++;
+				hrtimer_start(&cp->coal_timer,
+					      ns_to_ktime((u64)cp->rx_coalesce_usecs * NSEC_PER_USEC),
+					      HRTIMER_MODE_REL);
+			}
+		} else if (napi_complete_done(napi, work_done)) {
+			rtl819x_enable_napi_irq();
 		}
 	}
 
 	return work_done;
 }
 
+/**
+ * rtl819x_coal_timer - RX hold-off expiry
+ * @t: coal_timer embedded in dev_priv
+ *
+ * Runs in hardirq context once the hold-off armed by rtl819x_poll() ends.
+ * Interrupts are still masked (and rtl_rxSetTxDone() still counts the
+ * ISR's disable), so simply schedule another poll; that poll decides
+ * whether to hold off again or to unmask.
+ */
+static enum hrtimer_restart rtl819x_coal_timer(struct hrtimer *t)
+{
+	struct dev_priv *cp = container_of(t, struct dev_priv, coal_timer);
+
+#ifdef CONFIG_RTL819X_LATENCY_HIST
+	rtl_rx_irq_ticks = rtl819x_timer_read();
+#endif
+	if (likely(!atomic_read(&rtl_driver_shutting_down)))
+		napi_schedule(&cp->napi);
+
+	return HRTIMER_NORESTART;
+}
+
 /**
  * interrupt_isr_napi - NAPI interrupt service routine
  * @irq: IRQ number
@@ -1347,6 +1596,8 @@ static irqreturn_t interrupt_isr_napi(int irq, void *dev_instance)
 	struct dev_priv *cp = netdev_priv(dev);
 	unsigned int status;
 
+	rtl819x_irq_latency_mark(irq);
+
 	/* Read and clear interrupt status */
 	status = REG32(CPUIISR);
 	REG32(CPUIISR) = status;
@@ -1356,8 +1607,12 @@ static irqreturn_t interrupt_isr_napi(int irq, void *dev_instance)
 	 * Optimization: Branch hints for common (RX/TX) vs rare (link/error) events
 	 */
 	cnt_swcore++;
-	if (likely(status & RX_DONE_IP_ALL))
+	if (likely(status & RX_DONE_IP_ALL)) {
 		cnt_swcore_rx++;
+#ifdef CONFIG_RTL819X_LATENCY_HIST
+		rtl_rx_irq_ticks = rtl819x_timer_read();
+#endif
+	}
 	if (likely(status & TX_ALL_DONE_IP_ALL))
 		cnt_swcore_tx++;
 	if (unlikely(status & LINK_CHANGE_IP))
@@ -1496,15 +1751,94 @@ static int rtl819xD_checkPhyCbSnr(void)
 }
 
 
-static void interrupt_dsr_link(unsigned long task_priv)
+/*
+ * Phase 8: rtl_link_update() runs from the link tasklet, the one second
+ * timer, re865x_open() and the end of a switch core reinit. rtl_link_lock
+ * serializes them around curLinkPortMask/newLinkPortMask and the carrier
+ * updates. The FDB flush of downed ports walks the whole ASIC L2 table
+ * (the switch has no per-port flush), so it is left to rtl_fdb_flush_work
+ * in process context, with interrupts and BHs on.
+ */
+static DEFINE_SPINLOCK(rtl_link_lock);
+static unsigned int rtl_fdb_flush_mask;		/* ports waiting for a flush */
+
+static void rtl_fdb_flush_fn(struct work_struct *work)
+{
+	unsigned int mask;
+	int port;
+
+	spin_lock_bh(&rtl_link_lock);
+	mask = rtl_fdb_flush_mask;
+	rtl_fdb_flush_mask = 0;
+	spin_unlock_bh(&rtl_link_lock);
+
+	for (port = 0; port < RTL8651_PHY_NUMBER; port++)
+	{
+		if (mask & (1 << port))
+			_rtl865x_ClearFDBEntryByPort(port);
+	}
+}
+static DECLARE_WORK(rtl_fdb_flush_work, rtl_fdb_flush_fn);
+
+/**
+ * rtl_link_update - Propagate PHY link state to the stack and the FDB
+ *
+ * Updates the ASIC link table, queues the flush of dynamic FDB entries
+ * learned on ports that went down (so traffic is not forwarded to a dead
+ * port until they age out) and sets the carrier of every interface whose
+ * member ports are all down or at least one is up.
+ *
+ * Process or softirq context.
+ */
+static void rtl_link_update(void)
 {
+	unsigned int downPortMask;
+	int i;
+
+	spin_lock_bh(&rtl_link_lock);
 
 	newLinkPortMask = rtl865x_getPhysicalPortLinkStatus();
+	downPortMask = curLinkPortMask & ~newLinkPortMask;
 
 	rtl865x_LinkChange_Process();
 
+	rtl_fdb_flush_mask |= downPortMask;
+
+	for (i = 0; i < ETH_INTF_NUM; i++)
+	{
+		struct net_device *dev = _rtl86xx_dev.dev[i];
+		struct dev_priv *tmp_cp;
+
+		if (!dev)
+			continue;
+		tmp_cp = (struct dev_priv *)netdev_priv(dev);
+		if (!tmp_cp->portmask)
+			continue;
+
+		if (tmp_cp->portmask & newLinkPortMask)
+		{
+			if (!netif_carrier_ok(dev))
+				netif_carrier_on(dev);
+		}
+		else if (netif_carrier_ok(dev))
+		{
+			netif_carrier_off(dev);
+		}
+	}
+
 	curLinkPortMask = newLinkPortMask;
 
+	spin_unlock_bh(&rtl_link_lock);
+
+	if (downPortMask)
+		schedule_work(&rtl_fdb_flush_work);
+}
+
+static void interrupt_dsr_link(unsigned long task_priv)
+{
+	if (rtl865x_duringReInitSwtichCore == 0)
+		rtl_link_update();
+
 	REG32(CPUIIMR) |= (LINK_CHANGE_IP);
 
 	return;
@@ -1519,6 +1853,16 @@ static inline void rtl_link_change_interrupt_process(unsigned int status, struct
 	}
 }
 
+/* Phase 8: One line summary of what the current sizing costs in RAM */
+static void rtl_mem_report(void)
+{
+	printk(KERN_INFO "%s: rx ring %u, tx ring %u, prealloc %d: descriptors %u KB, "
+	       "SKB pool %u buffers (%lu KB)\n", DRV_NAME,
+	       rxRingSize[0], txRingSize[0], rtl865x_maxPreAllocRxSkb,
+	       swNic_memFootprint() >> 10, eth_skb_total_num,
+	       (eth_pool_chunk_cnt * (PAGE_SIZE << RTL_ETH_POOL_ORDER)) >> 10);
+}
+
 static int rtl865x_init_hw(void)
 {
 	unsigned int mbufRingSize;
@@ -1537,6 +1881,12 @@ static int rtl865x_init_hw(void)
 		return FAILED;
 	}
 
+	if (rtl_mem_report_pending)
+	{
+		rtl_mem_report_pending = false;
+		rtl_mem_report();
+	}
+
 	return SUCCESS;
 }
 
@@ -1572,17 +1922,17 @@ void refine_phy_setting(void)
 	return;
 }
 
-static void one_sec_timer(struct timer_list *t)
+/**
+ * rtl_swcore_watchdog - Detect a wedged switch core and reinitialise it
+ *
+ * A port of an opened interface with EnablePHYIf cleared means the switch
+ * core lost its configuration: re-enable its clock if needed, then run
+ * rtl865x_reinitSwitchCore(), spread over a few one_sec_timer() ticks.
+ */
+static void rtl_swcore_watchdog(void)
 {
-	unsigned long flags;
-	struct dev_priv *cp;
 	int i;
 
-	cp = from_timer(cp, t, expire_timer);  /* Kernel 5.4: timer callback signature changed */
-
-	// spin_lock_irqsave (&cp->lock, flags);
-	local_irq_save(flags);
-
 	for (i = 0; i < ETH_INTF_NUM; i++)
 	{
 		struct dev_priv *tmp_cp;
@@ -1646,6 +1996,30 @@ static void one_sec_timer(struct timer_list *t)
 			}
 		}
 	}
+}
+
+/*
+ * Phase 8: one_sec_timer() no longer runs with interrupts disabled.
+ * Link changes come from interrupt_dsr_link(); the port scan below is a
+ * slow fallback, and rtl865x_reinitSwitchCore() masks interrupts itself.
+ */
+static void one_sec_timer(struct timer_list *t)
+{
+	struct dev_priv *cp;
+
+	cp = from_timer(cp, t, expire_timer);  /* Kernel 5.4: timer callback signature changed */
+
+	/* Every tick while a reinit is pending, else every WATCHDOG_PERIOD */
+	if ((rtl865x_reInitState != STATE_NO_ERROR) ||
+	    ((++rtl_link_watchdog_tick % RTL_LINK_WATCHDOG_PERIOD) == 0))
+	{
+		if ((rtl865x_duringReInitSwtichCore == 0) &&
+		    (rtl865x_getPhysicalPortLinkStatus() != curLinkPortMask))
+			rtl_link_update();	/* missed link change interrupt */
+
+		rtl_swcore_watchdog();
+	}
+
 	rtl_check_swCore_tx_hang();
 
 	rtl819xD_checkPhyCbSnr();
@@ -1653,9 +2027,6 @@ static void one_sec_timer(struct timer_list *t)
 	refine_phy_setting();
 
 	mod_timer(&cp->expire_timer, jiffies + HZ);
-
-	// spin_unlock_irqrestore(&cp->lock, flags);
-	local_irq_restore(flags);
 }
 
 static struct net_device *irqDev = NULL;
@@ -1729,6 +2100,7 @@ static int re865x_open(struct net_device *dev)
 		irqDev = dev;
 		// cp->irq_owner =1;
 		rtl865x_start();
+		rtl_link_update();
 	}
 	else
 	{
@@ -1801,6 +2173,9 @@ static int re865x_close(struct net_device *dev)
 		/* Memory barrier to ensure flag is visible to all CPUs */
 		wmb();
 
+		/* Phase 8: A pending hold-off would reschedule NAPI */
+		hrtimer_cancel(&cp->coal_timer);
+
 		/* Phase 2: Disable NAPI (waits for poll to finish) */
 		napi_disable(&cp->napi);
 		netif_napi_del(&cp->napi);
@@ -1915,6 +2290,7 @@ static inline int rtl_isHwlookup(struct sk_buff *skb, struct dev_priv *cp, uint3
 
 	return flag;
 }
+
 static inline int rtl_fill_txInfo(rtl_nicTx_info *txInfo)
 {
     /* Conditionally declare variables used only when HW lookup is enabled */
@@ -1927,12 +2303,29 @@ static inline int rtl_fill_txInfo(rtl_nicTx_info *txInfo)
 
 	cp = netdev_priv(skb->dev);
 	txInfo->vid = cp->id;
+	txInfo->vlanTagPorts = 0;
 	// printk("%s %d txInfo->vid=%d  txInfo->portlist=0x%x \n", __FUNCTION__, __LINE__, txInfo->vid,  txInfo->portlist);
 
 	// default output queue is 0
 	txInfo->txIdx = 0;
-
-    if ((skb->data[0] & 0x01) == 0)
+	txInfo->priority = 0;
+
+	/* Phase 8: VLAN TX offload. The ASIC inserts the tag on the way out
+	 * (ph_txCVlanTagAutoAdd), with its PCP taken from ph_txPriority, so
+	 * the stack never memmoves one in. Such a VID need not exist in the
+	 * ASIC VLAN table, and so has no FID the ASIC learns into: bypass the
+	 * hardware L2 lookup and send to every port of the interface. An FDB
+	 * lookup here would cost indirect L2 table reads per frame, with
+	 * IRQs off, for a table that does not hold these stations.
+	 */
+	if (skb_vlan_tag_present(skb) && skb_vlan_tag_get_id(skb) != cp->id)
+	{
+		txInfo->vid = skb_vlan_tag_get_id(skb);
+		txInfo->priority = skb_vlan_tag_get_prio(skb);
+		rtl_direct_txInfo(cp->portmask, txInfo);
+		txInfo->vlanTagPorts = txInfo->portlist;
+	}
+    else if ((skb->data[0] & 0x01) == 0)
     {
 #if RTL_FORCE_DIRECT_TX
         /* Force direct TX to VLAN member ports (no HW L2 lookup) */
@@ -1997,12 +2390,46 @@ static int re865x_start_xmit(struct sk_buff *skb, struct net_device *dev)
 		return NETDEV_TX_OK;
 	}
 
+	/* Phase 8: Fragments the mbuf chain cannot carry, or a runt that
+	 * would need padding across fragments, fall back to a linear copy.
+	 */
+	if (unlikely(skb_shinfo(tx_skb)->nr_frags &&
+		     (skb_shinfo(tx_skb)->nr_frags > RTL865X_SWNIC_TX_MAX_FRAGS ||
+		      tx_skb->len < ETH_ZLEN)) &&
+	    __skb_linearize(tx_skb))
+	{
+		cp->net_stats.tx_dropped++;
+		dev_kfree_skb_any(tx_skb);
+		return NETDEV_TX_OK;
+	}
+
 	retval = rtl_fill_txInfo(&nicTx);
 	if (FAILED == retval)
 		return NETDEV_TX_OK;
 
-	/* Flush DMA cache for SKB (handles scatter-gather fragments) - Issue #3 */
-	rtl_skb_dma_cache_wback_inv(tx_skb);
+	/* Phase 8: L3/L4 checksums filled in by the ALE. It parses the
+	 * frame itself and only knows TCP/UDP over IPv4 (a tag in the
+	 * payload hides it, the vlan_tci tag does not): anything else the
+	 * stack leaves partial is completed in software.
+	 */
+	if (tx_skb->ip_summed == CHECKSUM_PARTIAL)
+	{
+		if (likely(tx_skb->protocol == htons(ETH_P_IP) &&
+			   (ip_hdr(tx_skb)->protocol == IPPROTO_TCP ||
+			    ip_hdr(tx_skb)->protocol == IPPROTO_UDP)))
+			nicTx.flags |= (CSUM_IP | CSUM_L4);
+		else if (skb_checksum_help(tx_skb))
+		{
+			cp->net_stats.tx_dropped++;
+			dev_kfree_skb_any(tx_skb);
+			return NETDEV_TX_OK;
+		}
+	}
+
+	/*
+	 * Cache write-back of the linear part and of each page fragment is
+	 * done by _swNic_send() when the buffers are attached to their mbufs.
+	 */
 
 	/* Try to send packet to TX ring */
 	retval = swNic_send((void *)tx_skb, tx_skb->data, tx_skb->len, &nicTx);
@@ -2085,40 +2512,171 @@ int rtl819x_get_port_status(int portnum, struct lan_port_status *port_status)
 	return 0;
 }
 
+/* =============================================================================
+ * Phase 8: Batched MIB counter snapshot
+ * =============================================================================
+ */
+
+/* Contiguous MIB words read per port: IN block up to dot3StatsFCSErrors,
+ * OUT block up to etherStatsCollisions.
+ */
+#define RTL_MIB_PORTS (CPU + 1)
+#define RTL_MIB_RX_WORDS (((OFFSET_DOT3STATSFCSERRORS_P0 - OFFSET_IFINOCTETS_P0) >> 2) + 1)
+#define RTL_MIB_TX_WORDS (((OFFSET_ETHERSTATSCOLLISIONS_P0 - OFFSET_IFOUTOCTETS_P0) >> 2) + 1)
+#define RTL_MIB_RX_IDX(off) (((off) - OFFSET_IFINOCTETS_P0) >> 2)
+#define RTL_MIB_TX_IDX(off) (((off) - OFFSET_IFOUTOCTETS_P0) >> 2)
+
+#define RTL_MIB_REFRESH_MIN_MS 100
+#define RTL_MIB_REFRESH_MAX_MS 60000	/* ifInOctets wraps in ~340 s at 100 Mbps */
+
+static unsigned int rtl_mib_refresh_ms = 1000;
+module_param(rtl_mib_refresh_ms, uint, 0644);
+MODULE_PARM_DESC(rtl_mib_refresh_ms, "MIB snapshot refresh period in ms (100-60000)");
+
+static struct
+{
+	struct rtl_mib_port port[RTL_MIB_PORTS];	/* 64-bit totals */
+	u32 raw_rx[RTL_MIB_PORTS][RTL_MIB_RX_WORDS];	/* last ASIC readings */
+	u32 raw_tx[RTL_MIB_PORTS][RTL_MIB_TX_WORDS];
+	unsigned long stamp;				/* jiffies of last refresh */
+	bool resync;					/* next pass only takes a baseline */
+} rtl_mib = { .resync = true };
+
+static DEFINE_SPINLOCK(rtl_mib_lock);
+static struct delayed_work rtl_mib_work;
+
+/**
+ * rtl_mib_refresh - Read every port MIB block and update the snapshot
+ *
+ * Each counter is accumulated as a 32-bit delta from the previous pass, so
+ * totals keep growing across hardware wraps as long as the refresh period
+ * stays below the wrap time. After an ASIC reset (rtl_mib.resync) the pass
+ * only records a new baseline.
+ */
+static void rtl_mib_refresh(void)
+{
+	u32 rx[RTL_MIB_RX_WORDS], tx[RTL_MIB_TX_WORDS];
+	struct rtl_mib_port *p;
+	u32 base;
+	int port, i;
+
+	spin_lock_bh(&rtl_mib_lock);
+	for (port = 0; port < RTL_MIB_PORTS; port++)
+	{
+		base = port * MIB_ADDROFFSETBYPORT;
+		for (i = 0; i < RTL_MIB_RX_WORDS; i++)
+			rx[i] = rtl8651_returnAsicCounter(OFFSET_IFINOCTETS_P0 + base + (i << 2));
+		for (i = 0; i < RTL_MIB_TX_WORDS; i++)
+			tx[i] = rtl8651_returnAsicCounter(OFFSET_IFOUTOCTETS_P0 + base + (i << 2));
+
+		if (!rtl_mib.resync)
+		{
+#define RX_DELTA(off) ((u32)(rx[RTL_MIB_RX_IDX(off)] - rtl_mib.raw_rx[port][RTL_MIB_RX_IDX(off)]))
+#define TX_DELTA(off) ((u32)(tx[RTL_MIB_TX_IDX(off)] - rtl_mib.raw_tx[port][RTL_MIB_TX_IDX(off)]))
+			p = &rtl_mib.port[port];
+			p->rx_bytes += RX_DELTA(OFFSET_IFINOCTETS_P0);
+			p->rx_unipkts += RX_DELTA(OFFSET_IFINUCASTPKTS_P0);
+			p->rx_mulpkts += RX_DELTA(OFFSET_ETHERSTATSMULTICASTPKTS_P0);
+			p->rx_bropkts += RX_DELTA(OFFSET_ETHERSTATSBROADCASTPKTS_P0);
+			p->rx_discard += RX_DELTA(OFFSET_DOT1DTPPORTINDISCARDS_P0);
+			p->rx_fcs_errors += RX_DELTA(OFFSET_DOT3STATSFCSERRORS_P0);
+			p->rx_jabbers += RX_DELTA(OFFSET_ETHERSTATSJABBERS_P0);
+			p->tx_bytes += TX_DELTA(OFFSET_IFOUTOCTETS_P0);
+			p->tx_unipkts += TX_DELTA(OFFSET_IFOUTUCASTPKTS_P0);
+			p->tx_mulpkts += TX_DELTA(OFFSET_IFOUTMULTICASTPKTS_P0);
+			p->tx_bropkts += TX_DELTA(OFFSET_IFOUTBROADCASTPKTS_P0);
+			p->tx_discard += TX_DELTA(OFFSET_IFOUTDISCARDS);
+			p->tx_collisions += TX_DELTA(OFFSET_ETHERSTATSCOLLISIONS_P0);
+			p->tx_deferred += TX_DELTA(OFFSET_DOT3STATSDEFERREDTRANSMISSIONS_P0);
+#undef RX_DELTA
+#undef TX_DELTA
+		}
+		memcpy(rtl_mib.raw_rx[port], rx, sizeof(rx));
+		memcpy(rtl_mib.raw_tx[port], tx, sizeof(tx));
+	}
+	rtl_mib.resync = false;
+	rtl_mib.stamp = jiffies;
+	spin_unlock_bh(&rtl_mib_lock);
+}
+
+static void rtl_mib_work_fn(struct work_struct *work)
+{
+	/* Counters are meaningless while the switch core is being reset */
+	if (rtl865x_duringReInitSwtichCore == 0)
+		rtl_mib_refresh();
+
+	schedule_delayed_work(&rtl_mib_work,
+			      msecs_to_jiffies(clamp_t(unsigned int, rtl_mib_refresh_ms,
+						       RTL_MIB_REFRESH_MIN_MS,
+						       RTL_MIB_REFRESH_MAX_MS)));
+}
+
+static void rtl_mib_start(void)
+{
+	INIT_DELAYED_WORK(&rtl_mib_work, rtl_mib_work_fn);
+	schedule_delayed_work(&rtl_mib_work, 0);
+}
+
+static void rtl_mib_stop(void)
+{
+	cancel_delayed_work_sync(&rtl_mib_work);
+}
+
+/**
+ * rtl_mib_sum_ports - Sum the cached counters of a set of ports
+ * @portmask: Ports to add up (bit n = port n)
+ * @sum: Returned totals
+ * @stamp: If not NULL, returns the jiffies of the snapshot
+ *
+ * Never touches the ASIC: safe from any non-hardirq context.
+ */
+static void rtl_mib_sum_ports(u32 portmask, struct rtl_mib_port *sum,
+			      unsigned long *stamp)
+{
+	const u64 *src;
+	u64 *dst = (u64 *)sum;
+	int port, i;
+
+	memset(sum, 0, sizeof(*sum));
+
+	spin_lock_bh(&rtl_mib_lock);
+	for (port = 0; port < RTL_MIB_PORTS; port++)
+	{
+		if (!(portmask & (1 << port)))
+			continue;
+		src = (const u64 *)&rtl_mib.port[port];
+		for (i = 0; i < sizeof(*sum) / sizeof(u64); i++)
+			dst[i] += src[i];
+	}
+	if (stamp)
+		*stamp = rtl_mib.stamp;
+	spin_unlock_bh(&rtl_mib_lock);
+}
+
 int rtl819x_get_port_stats(int portnum, struct port_statistics *port_stats)
 {
-	uint32 addrOffset_fromP0 = 0;
+	struct rtl_mib_port mib;
 
 	/* Validate port number to prevent integer overflow */
 	if (unlikely(portnum < 0 || portnum > CPU))
 		return -1;
 
-	/*
-	 * Security fix (2025-11-21): Validate offset after multiplication
-	 * to prevent integer overflow leading to out-of-bounds register access.
-	 * Max safe offset: CPU * MIB_ADDROFFSETBYPORT = 6 * 0x80 = 0x300
-	 */
-	addrOffset_fromP0 = portnum * MIB_ADDROFFSETBYPORT;
-	if (unlikely(addrOffset_fromP0 > (CPU * MIB_ADDROFFSETBYPORT)))
-		return -EINVAL;
+	/* Phase 8: served from the MIB snapshot (legacy 32-bit ABI) */
+	rtl_mib_sum_ports(1 << portnum, &mib, NULL);
+
+	port_stats->rx_bytes = (unsigned int)mib.rx_bytes;
+	port_stats->rx_unipkts = (unsigned int)mib.rx_unipkts;
+	port_stats->rx_mulpkts = (unsigned int)mib.rx_mulpkts;
+	port_stats->rx_bropkts = (unsigned int)mib.rx_bropkts;
+	port_stats->rx_discard = (unsigned int)mib.rx_discard;
+	port_stats->rx_error = (unsigned int)(mib.rx_fcs_errors + mib.rx_jabbers);
 
-	// port_stats->rx_bytes =(uint32) (rtl865xC_returnAsicCounter64( OFFSET_IFINOCTETS_P0 + addrOffset_fromP0 )) ;
-	port_stats->rx_bytes = rtl8651_returnAsicCounter(OFFSET_IFINOCTETS_P0 + addrOffset_fromP0);
-	port_stats->rx_unipkts = rtl8651_returnAsicCounter(OFFSET_IFINUCASTPKTS_P0 + addrOffset_fromP0);
-	port_stats->rx_mulpkts = rtl8651_returnAsicCounter(OFFSET_ETHERSTATSMULTICASTPKTS_P0 + addrOffset_fromP0);
-	port_stats->rx_bropkts = rtl8651_returnAsicCounter(OFFSET_ETHERSTATSBROADCASTPKTS_P0 + addrOffset_fromP0);
-	port_stats->rx_discard = rtl8651_returnAsicCounter(OFFSET_DOT1DTPPORTINDISCARDS_P0 + addrOffset_fromP0);
-	port_stats->rx_error = (rtl8651_returnAsicCounter(OFFSET_DOT3STATSFCSERRORS_P0 + addrOffset_fromP0) +
-							rtl8651_returnAsicCounter(OFFSET_ETHERSTATSJABBERS_P0 + addrOffset_fromP0));
-
-	// port_stats->tx_bytes =(uint32) (rtl865xC_returnAsicCounter64( OFFSET_IFOUTOCTETS_P0 + addrOffset_fromP0 )) ;
-	port_stats->tx_bytes = rtl8651_returnAsicCounter(OFFSET_IFOUTOCTETS_P0 + addrOffset_fromP0);
-	port_stats->tx_unipkts = rtl8651_returnAsicCounter(OFFSET_IFOUTUCASTPKTS_P0 + addrOffset_fromP0);
-	port_stats->tx_mulpkts = rtl8651_returnAsicCounter(OFFSET_IFOUTMULTICASTPKTS_P0 + addrOffset_fromP0);
-	port_stats->tx_bropkts = rtl8651_returnAsicCounter(OFFSET_IFOUTBROADCASTPKTS_P0 + addrOffset_fromP0);
-	port_stats->tx_discard = rtl8651_returnAsicCounter(OFFSET_IFOUTDISCARDS + addrOffset_fromP0);
-	port_stats->tx_error = (rtl8651_returnAsicCounter(OFFSET_ETHERSTATSCOLLISIONS_P0 + addrOffset_fromP0) +
-							rtl8651_returnAsicCounter(OFFSET_DOT3STATSDEFERREDTRANSMISSIONS_P0 + addrOffset_fromP0));
+	port_stats->tx_bytes = (unsigned int)mib.tx_bytes;
+	port_stats->tx_unipkts = (unsigned int)mib.tx_unipkts;
+	port_stats->tx_mulpkts = (unsigned int)mib.tx_mulpkts;
+	port_stats->tx_bropkts = (unsigned int)mib.tx_bropkts;
+	port_stats->tx_discard = (unsigned int)mib.tx_discard;
+	port_stats->tx_error = (unsigned int)(mib.tx_collisions + mib.tx_deferred);
 
 	return 0;
 }
@@ -2399,6 +2957,28 @@ static const char rtl819x_gstrings_stats[][ETH_GSTRING_LEN] = {
 	"pool_free_current",  /* Real-time pool free count (not just failure snapshot) */
 	"tx_ring_full_errors",
 	"ring_recovery_count",
+	"rx_coal_holdoffs",
+	/* Phase 8: switch MIB, summed over member ports (cached snapshot) */
+	"mib_rx_bytes",
+	"mib_rx_unicast",
+	"mib_rx_multicast",
+	"mib_rx_broadcast",
+	"mib_rx_discards",
+	"mib_rx_fcs_errors",
+	"mib_rx_jabbers",
+	"mib_tx_bytes",
+	"mib_tx_unicast",
+	"mib_tx_multicast",
+	"mib_tx_broadcast",
+	"mib_tx_discards",
+	"mib_tx_collisions",
+	"mib_tx_deferred",
+	"mib_age_ms",
+	/* Phase 8: Memory footprint */
+	"mem_desc_bytes",
+	"mem_skb_pool_bytes",
+	/* Phase 8: RX metadata */
+	"rx_csum_drops",
 };
 
 #define RTL819X_STATS_LEN ARRAY_SIZE(rtl819x_gstrings_stats)
@@ -2430,6 +3010,8 @@ static void rtl819x_get_ethtool_stats(struct net_device *dev,
 {
 	unsigned long driver_stats[9];
 	struct dev_priv *cp = netdev_priv(dev);
+	struct rtl_mib_port mib;
+	unsigned long stamp;
 	int i;
 
 	/* Use accessor function to avoid MIPS alignment and symbol issues */
@@ -2448,6 +3030,21 @@ static void rtl819x_get_ethtool_stats(struct net_device *dev,
 	/* Phase 7: TX path instrumentation (2 counters) */
 	data[13] = (u64)cp->tx_ring_full_errors;
 	data[14] = (u64)cp->ring_recovery_count;
+
+	/* Phase 8: Interrupt moderation */
+	data[15] = (u64)cp->rx_coal_holdoffs;
+
+	/* Phase 8: MIB snapshot (14 counters + age), no ASIC access */
+	rtl_mib_sum_ports(cp->portmask, &mib, &stamp);
+	memcpy(&data[16], &mib, sizeof(mib));
+	data[16 + sizeof(mib) / sizeof(u64)] = jiffies_to_msecs(jiffies - stamp);
+
+	/* Phase 8: Memory footprint */
+	data[31] = swNic_memFootprint();
+	data[32] = (u64)eth_pool_chunk_cnt * (PAGE_SIZE << RTL_ETH_POOL_ORDER);
+
+	/* Phase 8: RX metadata */
+	data[33] = rtl_swnic_get_rx_csum_drops();
 }
 
 static void rtl819x_get_strings(struct net_device *dev, u32 stringset, u8 *data)
@@ -2515,16 +3112,153 @@ static void rtl819x_get_regs(struct net_device *dev, struct ethtool_regs *regs,
 	data[15] = REG32(CPUTPDCR0);  /* TX descriptor base ring 0 */
 }
 
-static const struct ethtool_ops rtl819x_ethtool_ops = {
-	.get_drvinfo		= rtl819x_get_drvinfo,
-	.get_sset_count		= rtl819x_get_sset_count,
-	.get_strings		= rtl819x_get_strings,
-	.get_ethtool_stats	= rtl819x_get_ethtool_stats,
-	/* Phase 1: Extended ethtool support */
-	.get_link		= ethtool_op_get_link,     /* Standard link status */
-	.get_regs_len		= rtl819x_get_regs_len,    /* Register dump size */
-	.get_regs		= rtl819x_get_regs,        /* Register dump for debugging */
-};
+/**
+ * rtl819x_get_coalesce - Report RX interrupt moderation (ethtool -c)
+ * @dev: Network device
+ * @ec: Coalesce parameters to fill
+ */
+static int rtl819x_get_coalesce(struct net_device *dev, struct ethtool_coalesce *ec)
+{
+	struct dev_priv *cp = netdev_priv(dev);
+
+	ec->rx_coalesce_usecs = cp->rx_coalesce_usecs;
+	ec->rx_max_coalesced_frames = cp->rx_max_coalesced_frames;
+	return 0;
+}
+
+/**
+ * rtl819x_coal_usecs_max - Longest RX hold-off ring 0 can absorb
+ *
+ * Minimum-size frames from one port at 100 Mbps line rate (148,810 pps)
+ * fill the whole of ring 0 in rxRingSize[0] frame times: 430 us for the
+ * smallest ring (64), 3.4 ms for the default (500).
+ */
+static u32 rtl819x_coal_usecs_max(void)
+{
+	return rxRingSize[0] * RTL_NIC_RX_FRAME_NS / NSEC_PER_USEC;
+}
+
+/**
+ * rtl819x_set_coalesce - Configure RX interrupt moderation (ethtool -C)
+ * @dev: Network device
+ * @ec: New coalesce parameters
+ *
+ * rx-usecs:   hold-off before re-polling once a poll saw rx-frames packets
+ *             (0 disables moderation: one IRQ per NAPI cycle). Ignored
+ *             while it is below hrtimer_resolution, i.e. on a kernel
+ *             without CONFIG_HIGH_RES_TIMERS. At most
+ *             rtl819x_coal_usecs_max(), which follows ethtool -G rx
+ * rx-frames:  batch size from which traffic is considered bulk; smaller
+ *             polls unmask interrupts immediately to keep latency low
+ *
+ * Takes effect at the next NAPI completion.
+ */
+static int rtl819x_set_coalesce(struct net_device *dev, struct ethtool_coalesce *ec)
+{
+	struct dev_priv *cp = netdev_priv(dev);
+
+	if (ec->rx_coalesce_usecs > rtl819x_coal_usecs_max())
+		return -EINVAL;
+	/* rx-frames 0 would keep IRQs masked forever (pure timer polling) */
+	if (ec->rx_max_coalesced_frames < 1 ||
+	    ec->rx_max_coalesced_frames > rxRingSize[0])
+		return -EINVAL;
+
+	cp->rx_coalesce_usecs = ec->rx_coalesce_usecs;
+	cp->rx_max_coalesced_frames = ec->rx_max_coalesced_frames;
+	return 0;
+}
+
+/**
+ * rtl819x_get_ringparam - Report ring 0 sizes (ethtool -g)
+ * @dev: Network device
+ * @ring: Ring parameters to fill
+ *
+ * Ring 0 carries all regular traffic; the small auxiliary rings are fixed.
+ */
+static void rtl819x_get_ringparam(struct net_device *dev, struct ethtool_ringparam *ring)
+{
+	ring->rx_max_pending = NUM_RX_PKTHDR_DESC_MAX;
+	ring->tx_max_pending = NUM_TX_PKTHDR_DESC_MAX;
+	ring->rx_pending = rxRingSize[0];
+	ring->tx_pending = txRingSize[0];
+}
+
+/**
+ * rtl819x_set_ringparam - Resize ring 0 (ethtool -G)
+ * @dev: Network device
+ * @ring: New ring parameters
+ *
+ * Rings and descriptor pools are shared by all interfaces, so the resize is
+ * refused while any of them is up. The rings are released here and
+ * swNic_init() rebuilds them with the new sizes on the next open. The SKB
+ * pool grows or gives back its free chunks to match.
+ *
+ * Return: 0 on success, -EINVAL for out of range sizes, -EBUSY while an
+ * interface is running
+ */
+static int rtl819x_set_ringparam(struct net_device *dev, struct ethtool_ringparam *ring)
+{
+	int i;
+
+	if (ring->rx_mini_pending || ring->rx_jumbo_pending)
+		return -EINVAL;
+	if (ring->rx_pending < NUM_RX_PKTHDR_DESC_MIN ||
+	    ring->rx_pending > NUM_RX_PKTHDR_DESC_MAX ||
+	    ring->tx_pending < NUM_TX_PKTHDR_DESC_MIN ||
+	    ring->tx_pending > NUM_TX_PKTHDR_DESC_MAX)
+		return -EINVAL;
+	if (ring->rx_pending == rxRingSize[0] && ring->tx_pending == txRingSize[0])
+		return 0;
+
+	/* Under RTNL, so no interface can come up behind our back */
+	for (i = 0; i < ETH_INTF_NUM; i++)
+		if (_rtl86xx_dev.dev[i] && netif_running(_rtl86xx_dev.dev[i]))
+			return -EBUSY;
+
+	/* Switch core is stopped and RX buffers are back in the pool */
+	swNic_freeTxRing();
+	swNic_freeRings();
+
+	rxRingSize[0] = rtl865x_rxSkbPktHdrDescNum = ring->rx_pending;
+	txRingSize[0] = rtl865x_txSkbPktHdrDescNum = ring->tx_pending;
+	/* A smaller ring 0 absorbs a shorter hold-off */
+	for (i = 0; i < ETH_INTF_NUM; i++)
+	{
+		struct dev_priv *cp;
+
+		if (!_rtl86xx_dev.dev[i])
+			continue;
+		cp = netdev_priv(_rtl86xx_dev.dev[i]);
+		cp->rx_coalesce_usecs = min(cp->rx_coalesce_usecs, rtl819x_coal_usecs_max());
+	}
+	if (rtl_eth_pool_grow(rtl_eth_pool_needed()))
+		printk(KERN_WARNING "%s: SKB pool limited to %u buffers\n",
+		       DRV_NAME, eth_skb_total_num);
+	rtl_eth_pool_shrink(rtl_eth_pool_needed());
+	rtl_mem_report_pending = true;
+
+	return 0;
+}
+
+static const struct ethtool_ops rtl819x_ethtool_ops = {
+	.supported_coalesce_params = ETHTOOL_COALESCE_RX_USECS |
+				     ETHTOOL_COALESCE_RX_MAX_FRAMES,
+	.get_drvinfo		= rtl819x_get_drvinfo,
+	.get_sset_count		= rtl819x_get_sset_count,
+	.get_strings		= rtl819x_get_strings,
+	.get_ethtool_stats	= rtl819x_get_ethtool_stats,
+	/* Phase 1: Extended ethtool support */
+	.get_link		= ethtool_op_get_link,     /* Standard link status */
+	.get_regs_len		= rtl819x_get_regs_len,    /* Register dump size */
+	.get_regs		= rtl819x_get_regs,        /* Register dump for debugging */
+	/* Phase 8: Interrupt moderation */
+	.get_coalesce		= rtl819x_get_coalesce,
+	.set_coalesce		= rtl819x_set_coalesce,
+	/* Phase 8: Ring sizing */
+	.get_ringparam		= rtl819x_get_ringparam,
+	.set_ringparam		= rtl819x_set_ringparam,
+};
 
 static const struct net_device_ops rtl819x_netdev_ops = {
 	.ndo_open = re865x_open,
@@ -2537,6 +3271,9 @@ static const struct net_device_ops rtl819x_netdev_ops = {
 	.ndo_start_xmit = re865x_start_xmit,
 	.ndo_tx_timeout = re865x_tx_timeout,
 	.ndo_change_mtu = rtl865x_set_mtu,
+#ifdef RTL819X_TC_POLICE_OFFLOAD
+	.ndo_setup_tc = rtl819x_setup_tc,  /* Phase 8: matchall police -> port rate limit */
+#endif
 
 };
 
@@ -2618,9 +3355,13 @@ static int __init re865x_legacy_init(void)
 					   rtl865x_txSkbPktHdrDescNum ==
 					   RTL865X_PREALLOC_SKB_UNASIGNED);
 
-				rtl865x_maxPreAllocRxSkb = MAX_PRE_ALLOC_RX_SKB;
-				rtl865x_rxSkbPktHdrDescNum = NUM_RX_PKTHDR_DESC;
-				rtl865x_txSkbPktHdrDescNum = NUM_TX_PKTHDR_DESC;
+				rtl865x_maxPreAllocRxSkb = clamp(rtl_rx_prealloc, 0, NUM_RX_PKTHDR_DESC_MAX);
+				rtl865x_rxSkbPktHdrDescNum = clamp(rtl_rx_ring_size,
+					NUM_RX_PKTHDR_DESC_MIN, NUM_RX_PKTHDR_DESC_MAX);
+				rtl865x_txSkbPktHdrDescNum = clamp(rtl_tx_ring_size,
+					NUM_TX_PKTHDR_DESC_MIN, NUM_TX_PKTHDR_DESC_MAX);
+				rxRingSize[0] = rtl865x_rxSkbPktHdrDescNum;
+				txRingSize[0] = rtl865x_txSkbPktHdrDescNum;
 			}
 			else
 			{
@@ -2646,6 +3387,10 @@ static int __init re865x_legacy_init(void)
 
 	INIT_CHECK(rtl865x_config(vlanconfig));
 
+	if (rtl_prio_rx_setup(vlanconfig) != SUCCESS)
+		printk(KERN_WARNING "%s: priority RX ACL for port %u not installed\n",
+		       DRV_NAME, rtl_prio_rx_port);
+
 	/* create all default VLANs */
 	//	rtlglue_printf("	creating eth0~eth%d...\n",totalVlans-1 );
 
@@ -2681,6 +3426,30 @@ static int __init re865x_legacy_init(void)
 		dev->netdev_ops = &rtl819x_netdev_ops;
 		dev->ethtool_ops = &rtl819x_ethtool_ops;  /* Kernel 5.4: SET_ETHTOOL_OPS removed */
 		dev->watchdog_timeo = TX_TIMEOUT;
+
+		/* Phase 8: 802.1Q tag insertion/extraction via the packet header */
+		dev->hw_features = NETIF_F_HW_VLAN_CTAG_RX | NETIF_F_HW_VLAN_CTAG_TX;
+		/*
+		 * Phase 8: chained-mbuf TX and ALE checksum insertion
+		 * (CSUM_IP/CSUM_L4, the SDK's CSUM_IP/CSUM_TCPUDP pkthdr bits).
+		 * Both on by default: the core drops SG when no checksum
+		 * offload is enabled, so "ethtool -K ethX tx off" also turns
+		 * scatter-gather off.
+		 */
+		dev->hw_features |= NETIF_F_SG | NETIF_F_IP_CSUM;
+		/* Phase 8: software 4-tuple hash over ALE-validated headers */
+		dev->hw_features |= NETIF_F_RXHASH;
+#ifdef RTL819X_TC_POLICE_OFFLOAD
+		/* Phase 8: tc police offload to the switch bandwidth control */
+		dev->hw_features |= NETIF_F_HW_TC;
+#endif
+		dev->features |= dev->hw_features;
+
+		/* Phase 8: Adaptive RX interrupt moderation */
+		hrtimer_init(&dp->coal_timer, CLOCK_MONOTONIC, HRTIMER_MODE_REL);
+		dp->coal_timer.function = rtl819x_coal_timer;
+		dp->rx_coalesce_usecs = RTL_NIC_RX_COAL_USECS;
+		dp->rx_max_coalesced_frames = RTL_NIC_RX_COAL_FRAMES;
 		/* Kernel 5.4: Use Linux virtual IRQ mapped by INTC driver
 		 * Switch hardware IRQ 15 (rtl819x.dtsi) → Linux virtual IRQ = INTC_BASE + 15 = 16 + 15 = 31
 		 * See arch/mips/realtek/irq.c: REALTEK_INTC_IRQ_BASE=16, REALTEK_HW_SW_CORE_BIT=15 */
@@ -2715,24 +3484,116 @@ static int __init re865x_legacy_init(void)
 
 
 //---------------------------------------------------------------------------
-static void init_priv_eth_skb_buf(void)
+/* Buffers needed for full RX rings, a full pre-allocation queue and traffic
+ * held by the stack. rtl865x_maxPreAllocRxSkb already includes rings 1..5.
+ */
+static unsigned int rtl_eth_pool_needed(void)
 {
+	return rxRingSize[0] + rtl865x_maxPreAllocRxSkb + RTL_ETH_SKB_INFLIGHT;
+}
+
+/**
+ * rtl_eth_pool_grow - Add buffers to the private SKB pool
+ * @target: Wanted total number of pool buffers
+ *
+ * Allocates page chunks until the pool holds at least @target buffers.
+ *
+ * Return: 0 on success, -ENOMEM if the target could not be reached
+ */
+static int rtl_eth_pool_grow(unsigned int target)
+{
+	struct rtl_eth_pool_chunk *chunk;
+	struct priv_skb_buf2 *pb;
+	unsigned long flags;
 	int i;
 
-	DEBUG_ERR("Init priv skb.\n");
-	memset(eth_skb_buf, '\0', sizeof(struct priv_skb_buf2) * (MAX_ETH_SKB_NUM));
-	INIT_LIST_HEAD(&eth_skbbuf_list);
-	eth_skb_free_num = MAX_ETH_SKB_NUM;
+	while (eth_skb_total_num < target)
+	{
+		chunk = (struct rtl_eth_pool_chunk *)__get_free_pages(GFP_KERNEL | __GFP_ZERO,
+								       RTL_ETH_POOL_ORDER);
+		if (!chunk)
+			return -ENOMEM;
+
+		list_add_tail(&chunk->list, &eth_pool_chunks);
+		eth_pool_chunk_cnt++;
+
+		for (i = 0; i < RTL_ETH_POOL_CHUNK_BUFS; i++)
+		{
+			pb = &chunk->buf[i];
+			memcpy(pb->magic, ETH_MAGIC_CODE, ETH_MAGIC_LEN);
+			pb->buf_pointer = (void *)pb;
+			INIT_LIST_HEAD(&pb->list);
+		}
 
-	for (i = 0; i < MAX_ETH_SKB_NUM; i++)
+		local_irq_save(flags);
+		for (i = 0; i < RTL_ETH_POOL_CHUNK_BUFS; i++)
+			list_add_tail(&chunk->buf[i].list, &eth_skbbuf_list);
+		eth_skb_free_num += RTL_ETH_POOL_CHUNK_BUFS;
+		local_irq_restore(flags);
+
+		eth_skb_total_num += RTL_ETH_POOL_CHUNK_BUFS;
+	}
+
+	return 0;
+}
+
+/**
+ * rtl_eth_pool_shrink - Give unused pool chunks back to the page allocator
+ * @target: Total number of pool buffers to keep at least
+ *
+ * Frees the most recently added chunks while the pool stays at or above
+ * @target. A buffer in use has an empty list node (get_buf_from_poll()
+ * uses list_del_init()), so a chunk with any buffer still held by the
+ * stack stops the walk; a later resize picks it up.
+ */
+static void rtl_eth_pool_shrink(unsigned int target)
+{
+	struct rtl_eth_pool_chunk *chunk;
+	unsigned long flags;
+	int i;
+
+	while (eth_skb_total_num >= target + RTL_ETH_POOL_CHUNK_BUFS &&
+	       !list_empty(&eth_pool_chunks))
 	{
-		memcpy(eth_skb_buf[i].magic, ETH_MAGIC_CODE, ETH_MAGIC_LEN);
-		eth_skb_buf[i].buf_pointer = (void *)(&eth_skb_buf[i]);
-		INIT_LIST_HEAD(&eth_skb_buf[i].list);
-		list_add_tail(&eth_skb_buf[i].list, &eth_skbbuf_list);
+		chunk = list_last_entry(&eth_pool_chunks, struct rtl_eth_pool_chunk, list);
+
+		local_irq_save(flags);
+		for (i = 0; i < RTL_ETH_POOL_CHUNK_BUFS; i++)
+			if (list_empty(&chunk->buf[i].list))
+				break;
+		if (i < RTL_ETH_POOL_CHUNK_BUFS)
+		{
+			local_irq_restore(flags);
+			break;
+		}
+		for (i = 0; i < RTL_ETH_POOL_CHUNK_BUFS; i++)
+		{
+			list_del(&chunk->buf[i].list);
+			/* Stale magic in a reused page must not look like a pool buffer */
+			chunk->buf[i].buf_pointer = NULL;
+		}
+		eth_skb_free_num -= RTL_ETH_POOL_CHUNK_BUFS;
+		local_irq_restore(flags);
+
+		list_del(&chunk->list);
+		eth_pool_chunk_cnt--;
+		eth_skb_total_num -= RTL_ETH_POOL_CHUNK_BUFS;
+		free_pages((unsigned long)chunk, RTL_ETH_POOL_ORDER);
 	}
 }
 
+static void init_priv_eth_skb_buf(void)
+{
+	DEBUG_ERR("Init priv skb.\n");
+	INIT_LIST_HEAD(&eth_skbbuf_list);
+	eth_skb_free_num = 0;
+	eth_skb_total_num = 0;
+
+	if (rtl_eth_pool_grow(rtl_eth_pool_needed()))
+		printk(KERN_WARNING "%s: SKB pool limited to %u buffers\n",
+		       DRV_NAME, eth_skb_total_num);
+}
+
 static __inline__ unsigned char *get_buf_from_poll(struct list_head *phead, unsigned int *count)
 {
 	unsigned long flags;
@@ -2848,37 +3709,199 @@ int is_rtl865x_eth_priv_buf(unsigned char *head)
 }
 EXPORT_SYMBOL(is_rtl865x_eth_priv_buf);
 
+/**
+ * priv_skb_copy - Duplicate an SKB for a path that outlives the RX ring
+ * @skb: Source SKB, usually backed by a private pool buffer
+ *
+ * Phase 8: Pool buffers are refcounted like any SKB head (shinfo dataref)
+ * and go back to the pool from skb_free_head() on the last reference, so
+ * the duplicate simply shares the buffer. This used to take a second pool
+ * buffer (or a pre-allocated RX SKB) and copy the whole packet.
+ *
+ * When the pool runs low the packet is copied into regular kernel memory
+ * instead, so a slow consumer cannot pin the buffers RX refill needs.
+ * As with any clone, callers that modify the data must skb_unshare() it.
+ *
+ * Return: New SKB, or NULL on allocation failure
+ */
 struct sk_buff *priv_skb_copy(struct sk_buff *skb)
 {
-	struct sk_buff *n;
-	unsigned long flags;
+	if (eth_skb_free_num < RTL_ETH_POOL_LOW_WATER && is_rtl865x_eth_priv_buf(skb->head))
+		return skb_copy(skb, GFP_ATOMIC);
 
-	if (rx_skb_queue.qlen == 0)
-	{
-		n = dev_alloc_skb_priv_eth(CROSS_LAN_MBUF_LEN);
+	return skb_clone(skb, GFP_ATOMIC);
+}
+EXPORT_SYMBOL(priv_skb_copy);
+
+/* ========================================================================== */
+/* Phase 8: Latency histograms and debugfs                                    */
+/* ========================================================================== */
+
+#ifdef CONFIG_RTL819X_LATENCY_HIST
+struct rtl_lat_hist rtl_rx_lat_hist;	/* RX IRQ -> napi_gro_receive() */
+struct rtl_lat_hist rtl_tx_lat_hist;	/* TX enqueue -> descriptor reclaimed */
+
+/**
+ * rtl_lat_hist_add - Account one latency sample
+ * @h: Histogram
+ * @ticks: Elapsed SoC timer ticks (rtl819x_timer_delta())
+ *
+ * Called with BHs disabled only (NAPI poll, xmit reclaim), so no locking.
+ * Bucket 0 is < 1 us, bucket n covers [2^(n-1), 2^n) us, the last bucket
+ * collects everything above.
+ */
+void rtl_lat_hist_add(struct rtl_lat_hist *h, u32 ticks)
+{
+	u64 ns64 = rtl819x_timer_ticks_to_ns(ticks);
+	u32 ns = ns64 > U32_MAX ? U32_MAX : (u32)ns64;
+	u32 us = ns / NSEC_PER_USEC;
+	int b = us ? fls(us) : 0;
+
+	if (b >= RTL_LAT_HIST_BUCKETS)
+		b = RTL_LAT_HIST_BUCKETS - 1;
+
+	h->bucket[b]++;
+	h->count++;
+	h->sum_ns += ns;
+	if (ns > h->max_ns)
+		h->max_ns = ns;
+}
+
+static int rtl_lat_hist_show(struct seq_file *m, void *v)
+{
+	struct rtl_lat_hist *h = m->private;
+	struct rtl_lat_hist snap;
+	u64 avg = 0;
+	int i;
+
+	/* Snapshot with BHs off so NAPI cannot update it halfway */
+	local_bh_disable();
+	snap = *h;
+	local_bh_enable();
+
+	if (snap.count) {
+		avg = snap.sum_ns;
+		do_div(avg, snap.count);
 	}
-	else
-	{
-		local_irq_save(flags);
-		n = rtk_dequeue(&rx_skb_queue);
-		local_irq_restore(flags);
+
+	seq_printf(m, "samples: %u  avg: %llu ns  max: %u ns\n",
+		   snap.count, avg, snap.max_ns);
+	for (i = 0; i < RTL_LAT_HIST_BUCKETS; i++) {
+		if (i == 0)
+			seq_printf(m, "%8s - %6u us: %u\n", "0", 1, snap.bucket[i]);
+		else if (i == RTL_LAT_HIST_BUCKETS - 1)
+			seq_printf(m, "%8u - %6s us: %u\n", 1U << (i - 1), "inf", snap.bucket[i]);
+		else
+			seq_printf(m, "%8u - %6u us: %u\n", 1U << (i - 1), 1U << i, snap.bucket[i]);
 	}
+	return 0;
+}
 
-	if (n == NULL)
-	{
-		return NULL;
+static int rtl_lat_hist_open(struct inode *inode, struct file *file)
+{
+	return single_open(file, rtl_lat_hist_show, inode->i_private);
+}
+
+/* Any write resets the histogram */
+static ssize_t rtl_lat_hist_write(struct file *file, const char __user *buf,
+				  size_t count, loff_t *ppos)
+{
+	struct rtl_lat_hist *h = ((struct seq_file *)file->private_data)->private;
+
+	local_bh_disable();
+	memset(h, 0, sizeof(*h));
+	local_bh_enable();
+	return count;
+}
+
+static const struct file_operations rtl_lat_hist_fops = {
+	.owner		= THIS_MODULE,
+	.open		= rtl_lat_hist_open,
+	.read		= seq_read,
+	.write		= rtl_lat_hist_write,
+	.llseek		= seq_lseek,
+	.release	= single_release,
+};
+#endif /* CONFIG_RTL819X_LATENCY_HIST */
+
+#ifdef CONFIG_DEBUG_FS
+static struct dentry *rtl819x_debugfs_dir;
+
+/* Phase 8: per-port dump of the MIB snapshot */
+static int rtl_mib_show(struct seq_file *m, void *v)
+{
+	struct rtl_mib_port mib;
+	unsigned long stamp;
+	int port;
+
+	rtl_mib_sum_ports(0, &mib, &stamp);
+	seq_printf(m, "age: %u ms  refresh: %u ms\n",
+		   jiffies_to_msecs(jiffies - stamp), rtl_mib_refresh_ms);
+	seq_printf(m, "%-4s %12s %10s %8s %8s %8s %6s %12s %10s %8s %8s %8s %6s\n",
+		   "port", "rx_bytes", "rx_ucast", "rx_mcast", "rx_bcast",
+		   "rx_disc", "rx_err", "tx_bytes", "tx_ucast", "tx_mcast",
+		   "tx_bcast", "tx_disc", "tx_err");
+	for (port = 0; port < RTL_MIB_PORTS; port++) {
+		rtl_mib_sum_ports(1 << port, &mib, NULL);
+		seq_printf(m, "%-4d %12llu %10llu %8llu %8llu %8llu %6llu %12llu %10llu %8llu %8llu %8llu %6llu\n",
+			   port, mib.rx_bytes, mib.rx_unipkts, mib.rx_mulpkts,
+			   mib.rx_bropkts, mib.rx_discard,
+			   mib.rx_fcs_errors + mib.rx_jabbers,
+			   mib.tx_bytes, mib.tx_unipkts, mib.tx_mulpkts,
+			   mib.tx_bropkts, mib.tx_discard,
+			   mib.tx_collisions + mib.tx_deferred);
 	}
+	return 0;
+}
+DEFINE_SHOW_ATTRIBUTE(rtl_mib);
 
-	/* Set the tail pointer and length */
-	skb_put(n, skb->len);
-	n->csum = skb->csum;
-	n->ip_summed = skb->ip_summed;
-	memcpy(n->data, skb->data, skb->len);
+/* Phase 8: RX trap reasons as reported in ph_reason */
+static int rtl_rx_reasons_show(struct seq_file *m, void *v)
+{
+	struct rtl_rx_reason_slot slots[RTL_RX_REASON_SLOTS];
+	unsigned long other;
+	int i, n;
+
+	n = rtl_swnic_get_rx_reasons(slots, &other);
+	seq_printf(m, "%-8s %12s\n", "reason", "packets");
+	for (i = 0; i < n; i++)
+		seq_printf(m, "0x%04x   %12lu\n", slots[i].reason, slots[i].count);
+	seq_printf(m, "%-8s %12lu\n", "other", other);
+	seq_printf(m, "%-8s %12lu\n", "csum", rtl_swnic_get_rx_csum_drops());
+	return 0;
+}
+DEFINE_SHOW_ATTRIBUTE(rtl_rx_reasons);
 
-	skb_copy_header(n, skb);
-	return n;
+/**
+ * rtl819x_debugfs_init - Create /sys/kernel/debug/rtl819x
+ *
+ * Failures are not fatal: debugfs is diagnostics only.
+ */
+static void rtl819x_debugfs_init(void)
+{
+	rtl819x_debugfs_dir = debugfs_create_dir(DRV_NAME, NULL);
+
+	debugfs_create_file("mib", 0400, rtl819x_debugfs_dir, NULL, &rtl_mib_fops);
+	debugfs_create_file("rx_reasons", 0400, rtl819x_debugfs_dir, NULL,
+			    &rtl_rx_reasons_fops);
+
+#ifdef CONFIG_RTL819X_LATENCY_HIST
+	debugfs_create_file("rx_latency", 0600, rtl819x_debugfs_dir,
+			    &rtl_rx_lat_hist, &rtl_lat_hist_fops);
+	debugfs_create_file("tx_latency", 0600, rtl819x_debugfs_dir,
+			    &rtl_tx_lat_hist, &rtl_lat_hist_fops);
+#endif
 }
-EXPORT_SYMBOL(priv_skb_copy);
+
+static void rtl819x_debugfs_exit(void)
+{
+	debugfs_remove_recursive(rtl819x_debugfs_dir);
+	rtl819x_debugfs_dir = NULL;
+}
+#else
+static inline void rtl819x_debugfs_init(void) { }
+static inline void rtl819x_debugfs_exit(void) { }
+#endif /* CONFIG_DEBUG_FS */
 
 /**
  * rtl819x_parse_vlan_from_dt - Parse VLAN configuration from device tree
@@ -2894,6 +3917,8 @@ EXPORT_SYMBOL(priv_skb_copy);
  *       local-mac-address = [02 14 B8 ...];
  *       vlan-id = <1>;
  *       member-ports = <0x10>;
+ *       ingress-rate-kbps = <20000>;    (optional, each member port, < 100000)
+ *       egress-rate-kbps = <20000>;     (optional, each member port, < 100000)
  *       ...
  *   };
  *
@@ -2961,6 +3986,24 @@ static int rtl819x_parse_vlan_from_dt(struct platform_device *pdev)
 		if (of_property_read_u32(child, "mtu", &val) == 0)
 			vlanconfig[idx].mtu = val;
 
+		/* Phase 8: Optional switch-enforced rate limits for the member ports */
+		if (of_property_read_u32(child, "ingress-rate-kbps", &val) == 0) {
+			if (val >= RTL_PORT_RATE_MAX_KBPS) {
+				dev_warn(&pdev->dev, "Interface %s: ingress-rate-kbps %u not below line rate, ignored\n",
+					 ifname_str, val);
+				val = 0;
+			}
+			rtl_port_rate_store(vlanconfig[idx].memPort, true, val);
+		}
+		if (of_property_read_u32(child, "egress-rate-kbps", &val) == 0) {
+			if (val >= RTL_PORT_RATE_MAX_KBPS) {
+				dev_warn(&pdev->dev, "Interface %s: egress-rate-kbps %u not below line rate, ignored\n",
+					 ifname_str, val);
+				val = 0;
+			}
+			rtl_port_rate_store(vlanconfig[idx].memPort, false, val);
+		}
+
 		/* Set fixed values */
 		vlanconfig[idx].if_type = IF_ETHER;
 		vlanconfig[idx].is_slave = 0;
@@ -3007,6 +4050,9 @@ static int re865x_probe(struct platform_device *pdev)
 		return vlan_count;
 	}
 
+	/* Phase 8: Optional override of the priority RX ring port */
+	of_property_read_u32(pdev->dev.of_node, "priority-rx-port", &rtl_prio_rx_port);
+
 	/* Call legacy initialization function */
 	ret = re865x_legacy_init();
 	if (ret < 0) {
@@ -3017,6 +4063,10 @@ static int re865x_probe(struct platform_device *pdev)
 	/* Store platform_device in driver data for potential future use */
 	platform_set_drvdata(pdev, &_rtl86xx_dev);
 
+	rtl_rx_hash_seed = get_random_u32();
+	rtl_mib_start();
+	rtl819x_debugfs_init();
+
 	return 0;
 }
 
@@ -3033,6 +4083,10 @@ static int re865x_remove(struct platform_device *pdev)
 {
 	int i;
 
+	rtl819x_debugfs_exit();
+	rtl_mib_stop();
+	cancel_work_sync(&rtl_fdb_flush_work);
+
 	/* Unregister and free all network devices */
 	for (i = 0; i < ETH_INTF_NUM; i++) {
 		if (_rtl86xx_dev.dev[i]) {
@@ -3081,6 +4135,269 @@ static struct platform_driver rtl819x_eth_driver = {
 /* Register platform driver (replaces module_init/module_exit) */
 module_platform_driver(rtl819x_eth_driver);
 
+/* =============================================================================
+ * Phase 8: Priority RX ring
+ * =============================================================================
+ *
+ * The CPU port gets two output queues. An ingress ACL rule tags frames for
+ * rtl_prio_rx_port with priority 7, priority 7 maps to QID1, and QID1 maps
+ * to RX ring RTL_PRIO_RX_RING (QUEUEID1_RXRING_MAPPING). swNic_receive()
+ * harvests that ring first, so bridge traffic never waits behind a burst
+ * of bulk frames in ring 0.
+ */
+
+/**
+ * rtl_prio_rx_queue_setup - Map internal priority 7 to the priority queue
+ *
+ * ACL-based priority gets the highest decision weight so the rule wins
+ * over the port-based default. Must be re-run after every ASIC reset.
+ */
+static void rtl_prio_rx_queue_setup(void)
+{
+	int pri;
+
+	rtl8651_setAsicPriorityDecision(2, 1, 1, 8, 1);
+	for (pri = PRI0; pri <= PRI7; pri++)
+		rtl8651_setAsicPriorityToQIDMappingTable(QNUM2, pri,
+							 pri == PRI7 ? QUEUE1 : QUEUE0);
+}
+
+/**
+ * rtl_prio_rx_setup - Install the priority ACL rules on every interface
+ * @vlanconfig: Interface table, as passed to rtl865x_config()
+ *
+ * Registers the RTL865X_ACL_QOS_USED ingress chain (evaluated after the
+ * system chain) and adds one TCP and one UDP rule matching
+ * rtl_prio_rx_port as destination port. Safe to call again after an ASIC
+ * reset: an existing chain is flushed and its rules written back.
+ *
+ * Return: SUCCESS, or the first ACL error
+ */
+static int32 rtl_prio_rx_setup(struct rtl865x_vlanConfig vlanconfig[])
+{
+	rtl865x_AclRule_t rule;
+	int32 retval;
+	int i;
+
+	if (rtl_prio_rx_port == 0)
+		return SUCCESS;
+
+	for (i = 0; vlanconfig[i].vid != 0; i++)
+	{
+		if (vlanconfig[i].memPort == 0)
+			continue;
+
+		retval = rtl865x_regist_aclChain((char *)vlanconfig[i].ifname,
+						 RTL865X_ACL_QOS_USED, RTL865X_ACL_INGRESS);
+		if (retval == RTL_EENTRYALREADYEXIST)
+			retval = rtl865x_flush_allAcl_fromChain((char *)vlanconfig[i].ifname,
+								RTL865X_ACL_QOS_USED, RTL865X_ACL_INGRESS);
+		if (retval != SUCCESS)
+			return retval;
+	}
+
+	memset(&rule, 0, sizeof(rule));
+	rule.ruleType_ = RTL865X_ACL_TCP;
+	rule.actionType_ = RTL865X_ACL_PRIORITY;
+	rule.pktOpApp_ = RTL865X_ACL_ALL_LAYER;
+	rule.priority_ = PRI7;
+	rule.direction_ = RTL865X_ACL_INGRESS;
+	rule.tcpSrcPortLB_ = 0;
+	rule.tcpSrcPortUB_ = 0xffff;
+	rule.tcpDstPortLB_ = rtl_prio_rx_port;
+	rule.tcpDstPortUB_ = rtl_prio_rx_port;
+	retval = rtl865x_add_acl(&rule, NULL, RTL865X_ACL_QOS_USED);
+	if (retval != SUCCESS)
+		return retval;
+
+	memset(&rule, 0, sizeof(rule));
+	rule.ruleType_ = RTL865X_ACL_UDP;
+	rule.actionType_ = RTL865X_ACL_PRIORITY;
+	rule.pktOpApp_ = RTL865X_ACL_ALL_LAYER;
+	rule.priority_ = PRI7;
+	rule.direction_ = RTL865X_ACL_INGRESS;
+	rule.udpSrcPortLB_ = 0;
+	rule.udpSrcPortUB_ = 0xffff;
+	rule.udpDstPortLB_ = rtl_prio_rx_port;
+	rule.udpDstPortUB_ = rtl_prio_rx_port;
+	return rtl865x_add_acl(&rule, NULL, RTL865X_ACL_QOS_USED);
+}
+
+/* =============================================================================
+ * Phase 8: Hardware port rate limiting
+ * =============================================================================
+ *
+ * The switch has a per-port ingress leaky bucket (IBCR, 16 Kbps units) and a
+ * per-port egress rate (WFQRCR APR, 64 Kbps units). Policing there drops a
+ * LAN flood before it costs a single CPU cycle, unlike a software qdisc.
+ *
+ * Limits are set per interface but enforced per port: every member PHY
+ * port gets the full rate, so an interface with N member ports can carry
+ * up to N times the limit in aggregate. The switch polices the port, not
+ * the CPU path: "ingress" is every frame received on the port, including
+ * LAN-to-LAN traffic the switch forwards in hardware, and "egress" every
+ * frame sent on it.
+ *
+ * The tc offload below needs NET_SCHED, NET_CLS_MATCHALL and
+ * NET_ACT_POLICE, which the shipped configs leave out to keep the kernel
+ * small; there only the DT properties are active.
+ */
+
+/* Register disable values: 0 (ingress) and APR_MASK (egress) mean line rate */
+#define RTL_INGRESS_BW_UNIT_BPS 16384
+#define RTL_INGRESS_BW_MAX 0xFFFF
+#define RTL_EGRESS_BW_UNIT_BPS 65536
+#define RTL_EGRESS_BW_DISABLE 0x3FFF
+
+static void rtl_port_rate_store(u32 portmask, bool ingress, u32 kbps)
+{
+	int port;
+
+	for (port = 0; port < RTL8651_PHY_NUMBER; port++)
+	{
+		if (!(portmask & (1 << port)))
+			continue;
+		if (ingress)
+			rtl_port_ingress_kbps[port] = kbps;
+		else
+			rtl_port_egress_kbps[port] = kbps;
+	}
+}
+
+/**
+ * rtl_port_rate_apply - Program the stored port rate limits into the ASIC
+ *
+ * Rates are rounded up to the next register unit so a limit never ends
+ * up stricter than requested. Must be re-run after every ASIC reset.
+ */
+static void rtl_port_rate_apply(void)
+{
+	u32 bw;
+	int port;
+
+	for (port = 0; port < RTL8651_PHY_NUMBER; port++)
+	{
+		bw = 0;
+		if (rtl_port_ingress_kbps[port])
+			bw = min_t(u64, RTL_INGRESS_BW_MAX,
+				   DIV_ROUND_UP_ULL((u64)rtl_port_ingress_kbps[port] * 1000,
+						    RTL_INGRESS_BW_UNIT_BPS));
+		rtl8651_setAsicPortIngressBandwidth(port, bw);
+
+		bw = RTL_EGRESS_BW_DISABLE;
+		if (rtl_port_egress_kbps[port])
+			bw = min_t(u64, RTL_EGRESS_BW_DISABLE - 1,
+				   DIV_ROUND_UP_ULL((u64)rtl_port_egress_kbps[port] * 1000,
+						    RTL_EGRESS_BW_UNIT_BPS));
+		rtl8651_setAsicPortEgressBandwidth(port, bw);
+	}
+}
+
+#ifdef RTL819X_TC_POLICE_OFFLOAD
+static LIST_HEAD(rtl819x_block_cb_list);
+
+/**
+ * rtl819x_tc_matchall - Offload a matchall police rule to the port rate limit
+ * @cp: Interface private data
+ * @cls: matchall offload request
+ * @ingress: true for a clsact ingress block, false for egress
+ *
+ * Only a single police action is accepted; its rate becomes the limit of
+ * each member port (see above). The burst size is fixed by the switch
+ * leaky bucket parameters (rtl8651_setAsicLBParameter()) and is ignored.
+ *
+ * Return: 0 on success, -EOPNOTSUPP/-EINVAL for rules the switch cannot do
+ */
+static int rtl819x_tc_matchall(struct dev_priv *cp,
+			       struct tc_cls_matchall_offload *cls, bool ingress)
+{
+	struct netlink_ext_ack *extack = cls->common.extack;
+	struct flow_action_entry *act;
+	u64 kbps;
+
+	switch (cls->command)
+	{
+	case TC_CLSMATCHALL_REPLACE:
+		if (!flow_offload_has_one_action(&cls->rule->action)) {
+			NL_SET_ERR_MSG_MOD(extack, "only a single police action can be offloaded");
+			return -EOPNOTSUPP;
+		}
+		act = &cls->rule->action.entries[0];
+		if (act->id != FLOW_ACTION_POLICE) {
+			NL_SET_ERR_MSG_MOD(extack, "only the police action can be offloaded");
+			return -EOPNOTSUPP;
+		}
+		kbps = div_u64(act->police.rate_bytes_ps * 8, 1000);
+		if (kbps == 0) {
+			NL_SET_ERR_MSG_MOD(extack, "police rate below 1 kbit/s");
+			return -EINVAL;
+		}
+		if (kbps >= RTL_PORT_RATE_MAX_KBPS) {
+			NL_SET_ERR_MSG_MOD(extack, "police rate must be below the 100 Mbit/s line rate");
+			return -EINVAL;
+		}
+		rtl_port_rate_store(cp->portmask, ingress, (u32)kbps);
+		break;
+
+	case TC_CLSMATCHALL_DESTROY:
+		rtl_port_rate_store(cp->portmask, ingress, 0);
+		break;
+
+	default:
+		NL_SET_ERR_MSG_MOD(extack, "unsupported matchall command");
+		return -EOPNOTSUPP;
+	}
+
+	rtl_port_rate_apply();
+	return 0;
+}
+
+static int rtl819x_tc_block_cb_ingress(enum tc_setup_type type,
+				       void *type_data, void *cb_priv)
+{
+	if (type != TC_SETUP_CLSMATCHALL)
+		return -EOPNOTSUPP;
+	return rtl819x_tc_matchall(cb_priv, type_data, true);
+}
+
+static int rtl819x_tc_block_cb_egress(enum tc_setup_type type,
+				      void *type_data, void *cb_priv)
+{
+	if (type != TC_SETUP_CLSMATCHALL)
+		return -EOPNOTSUPP;
+	return rtl819x_tc_matchall(cb_priv, type_data, false);
+}
+
+/**
+ * rtl819x_setup_tc - ndo_setup_tc: bind clsact blocks for police offload
+ *
+ * Usage:
+ *   tc qdisc add dev eth0 clsact
+ *   tc filter add dev eth0 ingress matchall skip_sw \
+ *           action police rate 20mbit burst 64k
+ */
+static int rtl819x_setup_tc(struct net_device *dev, enum tc_setup_type type,
+			    void *type_data)
+{
+	struct dev_priv *cp = netdev_priv(dev);
+	struct flow_block_offload *f = type_data;
+	flow_setup_cb_t *cb;
+
+	if (type != TC_SETUP_BLOCK)
+		return -EOPNOTSUPP;
+
+	if (f->binder_type == FLOW_BLOCK_BINDER_TYPE_CLSACT_INGRESS)
+		cb = rtl819x_tc_block_cb_ingress;
+	else if (f->binder_type == FLOW_BLOCK_BINDER_TYPE_CLSACT_EGRESS)
+		cb = rtl819x_tc_block_cb_egress;
+	else
+		return -EOPNOTSUPP;
+
+	return flow_block_cb_setup_simple(f, &rtl819x_block_cb_list, cb,
+					  cp, cp, false);
+}
+#endif /* RTL819X_TC_POLICE_OFFLOAD */
+
 /**
  * rtl865x_init - Initialize L2 ASIC tables and driver structures
  *
@@ -3116,6 +4433,8 @@ int32 rtl865x_init(void)
 	REG32(CPUQDM4) = QUEUEID5_RXRING_MAPPING | (QUEUEID4_RXRING_MAPPING << 16);
 
 	rtl8651_setAsicOutputQueueNumber(CPU, RTL_CPU_RX_RING_NUM);
+	rtl_prio_rx_queue_setup();
+	rtl_port_rate_apply();
 
 
 	rtl_ps_drv_netif_mapping_init();
@@ -3238,6 +4557,10 @@ int re865x_reProbe(void)
 	memset(&para, 0, sizeof(rtl8651_tblAsic_InitPara_t));
 
 	INIT_CHECK(rtl865x_initAsicL2(&para));
+	/* MIB counters restart from zero. IRQs are already off: plain lock */
+	spin_lock(&rtl_mib_lock);
+	rtl_mib.resync = true;
+	spin_unlock(&rtl_mib_lock);
 
 	/*init PHY LED style*/
 	/*2007-12-19*/
@@ -3246,12 +4569,21 @@ int re865x_reProbe(void)
 	REG32(CPUQDM2) = QUEUEID3_RXRING_MAPPING | (QUEUEID2_RXRING_MAPPING << 16);
 	REG32(CPUQDM4) = QUEUEID5_RXRING_MAPPING | (QUEUEID4_RXRING_MAPPING << 16);
 	rtl8651_setAsicOutputQueueNumber(CPU, RTL_CPU_RX_RING_NUM);
+	rtl_prio_rx_queue_setup();
+	/* The reset wiped the ASIC ACL table: rules of both reinit paths */
+	if (rtl_prio_rx_setup(vlanconfig) != SUCCESS)
+		printk(KERN_WARNING "%s: priority RX ACL for port %u not reinstalled\n",
+		       DRV_NAME, rtl_prio_rx_port);
+	rtl_port_rate_apply();
 	local_irq_restore(flags);
 	return 0;
 }
 
 int rtl865x_reinitSwitchCore(void)
 {
+	unsigned long flags;
+
+	local_irq_save(flags);
 	/*enable switch core clock*/
 	rtl865x_duringReInitSwtichCore = 1;
 	/*disable switch core interrupt*/
@@ -3272,6 +4604,10 @@ int rtl865x_reinitSwitchCore(void)
 	REG32(GIMR) |= (BSP_SW_IE);
 
 	rtl865x_duringReInitSwtichCore = 0;
+	local_irq_restore(flags);
+
+	/* Link interrupts raised while the core was down were dropped */
+	rtl_link_update();
 	return 0;
 }
 
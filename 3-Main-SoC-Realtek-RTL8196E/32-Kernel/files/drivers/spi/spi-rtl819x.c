@@ -7,24 +7,32 @@
  * - Sélection du diviseur d'horloge en fonction de speed_hz
  * - CS par défaut = ALL_HIGH dans les cas inattendus
  * - remove/shutdown sans unregister/put (pas de crash au reboot)
+ * - spi-mem dirmap : lectures via la fenêtre mappée en mémoire (SFCR2)
+ * - Lectures/écritures Dual et Quad (spi-rx/tx-bus-width du DT)
+ * - Transferts longs découpés en blocs avec cond_resched() (chunk_size)
  */
 
 #include <linux/kernel.h>
 #include <linux/module.h>
 #include <linux/spinlock.h>
 #include <linux/platform_device.h>
+#include <linux/sched.h>
 #include <linux/io.h>
 #include <linux/bitops.h>
 #include <linux/spi/spi.h>
+#include <linux/spi/spi-mem.h>
 #include <linux/clk.h>
 #include <linux/err.h>
 #include <linux/of.h>
 #include <linux/iopoll.h>
+#include <linux/log2.h>
+#include <linux/sizes.h>
 
 #define DRIVER_NAME "realtek-spi"
 
 /* Registers */
 #define RTK_SPI_CONFIG_OFFSET 0x00
+#define RTK_SPI_CONFIG2_OFFSET 0x04 /* memory-mapped read setup (SFCR2) */
 #define RTK_SPI_CONTROL_STATUS_OFFSET 0x08
 #define RTK_SPI_DATA_OFFSET 0x0c
 
@@ -34,22 +42,46 @@
 #define RTK_SPI_WRITE_BYTE_ORDER BIT(27)
 #define RTK_SPI_CS_DESELECT_TIME_SHIFT 22 /* 5 bits, 0..31 */
 
+/* CONFIG2 bits: command issued by the controller for window reads */
+#define RTK_SPI_MMAP_CMD_SHIFT 24
+#define RTK_SPI_MMAP_SIZE_SHIFT 21 /* 3 bits: log2(window) - 17 */
+#define RTK_SPI_MMAP_CMD_IO_SHIFT 18 /* 2 bits: 0 single, 1 dual, 2 quad */
+#define RTK_SPI_MMAP_ADDR_IO_SHIFT 16
+#define RTK_SPI_MMAP_DUMMY_SHIFT 13 /* 3 bits: dummy cycles / 2 */
+#define RTK_SPI_MMAP_DATA_IO_SHIFT 11
+#define RTK_SPI_MMAP_DUMMY_MAX 14
+
 /* CONTROL/STATUS bits */
 #define RTK_SPI_CS_0_HIGH BIT(31)
 #define RTK_SPI_CS_1_HIGH BIT(30)
 #define RTK_SPI_CS_ALL_HIGH (RTK_SPI_CS_0_HIGH | RTK_SPI_CS_1_HIGH)
 #define RTK_SPI_DATA_LENGTH_SHIFT 28 /* 2 bits: (len-1) */
 #define RTK_SPI_READY BIT(27)
+#define RTK_SPI_IO_WIDTH_SHIFT 25 /* 2 bits: 0 single, 1 dual, 2 quad */
 
 /* Diviseurs possibles : parent_clk / {2,4,6,8,10,12,14,16} */
 static const u32 realtek_spi_clk_div_table[] = { 2, 4, 6, 8, 10, 12, 14, 16 };
 
+/*
+ * The controller has no ready interrupt: each 4-byte word is polled. With
+ * PREEMPT_NONE a 64 KB MTD read would otherwise hold the only CPU for tens
+ * of ms, starving the UART1 tty flip work and everything else. Long
+ * transfers give the scheduler a chance every chunk_size bytes (CS stays
+ * asserted, the flash simply sees a pause in the clock).
+ */
+static unsigned int chunk_size = 1024;
+module_param(chunk_size, uint, 0644);
+MODULE_PARM_DESC(chunk_size, "Bytes transferred between scheduling points (0: never yield)");
+
 struct realtek_spi_data {
 	struct spi_master *master;
 	void __iomem *base;
 	u32 ioc_base;
 	struct clk *clk; /* optionnel */
 	u32 parent_rate; /* Hz */
+	void __iomem *mmap; /* fenêtre flash (optionnelle, CS0) */
+	resource_size_t mmap_size;
+	u32 io_width; /* largeur du transfert en cours (champ IO_WIDTH) */
 };
 
 #ifdef CONFIG_CPU_BIG_ENDIAN
@@ -85,15 +117,37 @@ static inline void rtk_wr(struct realtek_spi_data *rsd, unsigned reg, u32 val)
 static int rtk_wait_ready(struct realtek_spi_data *rsd)
 {
 	u32 v;
-	/* 10 ms timeout, poll toutes les ~1 µs */
-	return readl_poll_timeout(rsd->base + RTK_SPI_CONTROL_STATUS_OFFSET, v,
-				  v & RTK_SPI_READY, 1, 10000);
+	/*
+	 * 10 ms timeout. A word takes ~1.3 µs at 25 MHz: spin rather than
+	 * usleep_range(), which without high-res timers sleeps a whole tick.
+	 */
+	return readl_poll_timeout_atomic(rsd->base + RTK_SPI_CONTROL_STATUS_OFFSET,
+					 v, v & RTK_SPI_READY, 0, 10000);
+}
+
+/* Yield once chunk_size bytes have been moved since the last yield */
+static inline void rtk_chunk_done(unsigned int *done, unsigned int bytes)
+{
+	unsigned int chunk = READ_ONCE(chunk_size);
+
+	*done += bytes;
+	if (chunk && *done >= chunk) {
+		*done = 0;
+		cond_resched();
+	}
+}
+
+/* Bus width (1/2/4 lines) to the IO_WIDTH encoding of SFCSR and SFCR2 */
+static u32 realtek_spi_buswidth(u8 buswidth)
+{
+	return buswidth == 4 ? 2 : buswidth == 2 ? 1 : 0;
 }
 
 static void rtk_set_txrx_size(struct realtek_spi_data *rsd, u32 size)
 {
 	rtk_wr(rsd, RTK_SPI_CONTROL_STATUS_OFFSET,
-	       rsd->ioc_base | ((size - 1) << RTK_SPI_DATA_LENGTH_SHIFT));
+	       rsd->ioc_base | ((size - 1) << RTK_SPI_DATA_LENGTH_SHIFT) |
+	       (rsd->io_width << RTK_SPI_IO_WIDTH_SHIFT));
 }
 
 static void rtk_set_default_config(struct realtek_spi_data *rsd, u32 div_idx)
@@ -167,6 +221,7 @@ static void realtek_spi_set_cs(struct spi_device *spi, bool cs_high)
 
 static int rtk_read(struct realtek_spi_data *rsd, u8 *buf, unsigned len)
 {
+	unsigned int done = 0;
 	int ret;
 
 	if ((size_t)buf % 4) {
@@ -191,6 +246,7 @@ static int rtk_read(struct realtek_spi_data *rsd, u8 *buf, unsigned len)
 			rtk_rr(rsd, RTK_SPI_DATA_OFFSET), 4);
 		buf += 4;
 		len -= 4;
+		rtk_chunk_done(&done, 4);
 	}
 
 	rtk_set_txrx_size(rsd, 1);
@@ -209,6 +265,7 @@ static int rtk_read(struct realtek_spi_data *rsd, u8 *buf, unsigned len)
 
 static int rtk_write(struct realtek_spi_data *rsd, const u8 *buf, unsigned len)
 {
+	unsigned int done = 0;
 	int ret;
 
 	if ((size_t)buf % 4) {
@@ -233,6 +290,7 @@ static int rtk_write(struct realtek_spi_data *rsd, const u8 *buf, unsigned len)
 			return ret;
 		buf += 4;
 		len -= 4;
+		rtk_chunk_done(&done, 4);
 	}
 
 	rtk_set_txrx_size(rsd, 1);
@@ -268,15 +326,112 @@ static int realtek_spi_transfer_one(struct spi_master *master,
 		return -EPERM;
 	}
 
-	if (xfer->tx_buf)
+	/*
+	 * spi-mem splits a multi-I/O op into transfers per phase (command,
+	 * address, dummy, data), each with its own width; the data register
+	 * then shifts 2 or 4 bits per clock.
+	 */
+	if (xfer->tx_buf) {
+		rsd->io_width = realtek_spi_buswidth(xfer->tx_nbits);
 		return rtk_write(rsd, (const u8 *)xfer->tx_buf, xfer->len);
+	}
 
-	if (xfer->rx_buf)
+	if (xfer->rx_buf) {
+		rsd->io_width = realtek_spi_buswidth(xfer->rx_nbits);
 		return rtk_read(rsd, (u8 *)xfer->rx_buf, xfer->len);
+	}
+
+	return 0;
+}
+
+/*
+ * spi-mem: reads through the memory-mapped flash window (0xbd000000, the
+ * bootloader's FLASH_BASE). The controller issues command, address and
+ * dummy cycles itself for every bus access, so a dirmap read is a plain
+ * copy from the window instead of one READY poll per 4 bytes through the
+ * data register. Everything else (ID, erase, program, status) still goes
+ * through transfer_one().
+ */
+static bool realtek_spi_mmap_op_ok(const struct spi_mem_op *op)
+{
+	unsigned int dummy_cycles = 0;
+
+	if (op->dummy.nbytes)
+		dummy_cycles = op->dummy.nbytes * 8 / op->dummy.buswidth;
+
+	return op->data.dir == SPI_MEM_DATA_IN &&
+	       op->cmd.buswidth == 1 &&
+	       op->addr.nbytes == 3 &&
+	       !(dummy_cycles & 1) && dummy_cycles <= RTK_SPI_MMAP_DUMMY_MAX;
+}
+
+static int realtek_spi_exec_op(struct spi_mem *mem, const struct spi_mem_op *op)
+{
+	/* Fall back to regular transfers for everything but dirmap reads */
+	return -ENOTSUPP;
+}
+
+static int realtek_spi_dirmap_create(struct spi_mem_dirmap_desc *desc)
+{
+	struct realtek_spi_data *rsd =
+		spi_master_get_devdata(desc->mem->spi->master);
+	const struct spi_mem_op *op = &desc->info.op_tmpl;
+
+	if (!rsd->mmap || desc->mem->spi->chip_select != 0)
+		return -ENOTSUPP;
+	if (!realtek_spi_mmap_op_ok(op))
+		return -ENOTSUPP;
+	if (desc->info.offset + desc->info.length > rsd->mmap_size)
+		return -ENOTSUPP;
 
 	return 0;
 }
 
+static ssize_t realtek_spi_dirmap_read(struct spi_mem_dirmap_desc *desc,
+				       u64 offs, size_t len, void *buf)
+{
+	struct spi_device *spi = desc->mem->spi;
+	struct realtek_spi_data *rsd = spi_master_get_devdata(spi->master);
+	const struct spi_mem_op *op = &desc->info.op_tmpl;
+	unsigned int dummy_cycles = 0;
+	void __iomem *src;
+	size_t done, n;
+	u32 cfg2;
+
+	if (op->dummy.nbytes)
+		dummy_cycles = op->dummy.nbytes * 8 / op->dummy.buswidth;
+
+	cfg2 = (op->cmd.opcode << RTK_SPI_MMAP_CMD_SHIFT) |
+	       ((ilog2(rsd->mmap_size) - 17) << RTK_SPI_MMAP_SIZE_SHIFT) |
+	       (realtek_spi_buswidth(op->cmd.buswidth) << RTK_SPI_MMAP_CMD_IO_SHIFT) |
+	       (realtek_spi_buswidth(op->addr.buswidth) << RTK_SPI_MMAP_ADDR_IO_SHIFT) |
+	       ((dummy_cycles / 2) << RTK_SPI_MMAP_DUMMY_SHIFT) |
+	       (realtek_spi_buswidth(op->data.buswidth) << RTK_SPI_MMAP_DATA_IO_SHIFT);
+
+	/* Same clock as PIO transfers to this device, CS released */
+	rtk_set_default_config(rsd, rtk_choose_div_idx(rsd, spi->max_speed_hz));
+	rtk_wr(rsd, RTK_SPI_CONFIG2_OFFSET, cfg2);
+	rtk_wr(rsd, RTK_SPI_CONTROL_STATUS_OFFSET,
+	       RTK_SPI_CS_ALL_HIGH | RTK_SPI_READY);
+
+	src = rsd->mmap + desc->info.offset + offs;
+	for (done = 0; done < len; done += n) {
+		n = READ_ONCE(chunk_size);
+		n = n ? min_t(size_t, n, len - done) : len - done;
+		memcpy_fromio(buf + done, src + done, n);
+		if (done + n < len)
+			cond_resched();
+	}
+
+	return len;
+}
+
+static const struct spi_controller_mem_ops realtek_spi_mem_ops = {
+	.exec_op = realtek_spi_exec_op,
+	.dirmap_create = realtek_spi_dirmap_create,
+	.dirmap_read = realtek_spi_dirmap_read,
+};
+
 static int realtek_spi_probe(struct platform_device *pdev)
 {
 	struct realtek_spi_data *rsd;
@@ -303,7 +458,8 @@ static int realtek_spi_probe(struct platform_device *pdev)
 
 	master->dev.of_node = pdev->dev.of_node;
 	master->num_chipselect = 2;
-	master->mode_bits = SPI_CPOL | SPI_CPHA | SPI_CS_HIGH;
+	master->mode_bits = SPI_CPOL | SPI_CPHA | SPI_CS_HIGH |
+			    SPI_RX_DUAL | SPI_RX_QUAD | SPI_TX_DUAL | SPI_TX_QUAD;
 	master->flags = SPI_MASTER_HALF_DUPLEX;
 	master->bits_per_word_mask = SPI_BPW_MASK(32) | SPI_BPW_MASK(24) |
 				     SPI_BPW_MASK(16) | SPI_BPW_MASK(8);
@@ -316,6 +472,20 @@ static int realtek_spi_probe(struct platform_device *pdev)
 	if (IS_ERR(rsd->base))
 		return PTR_ERR(rsd->base);
 
+	/* Fenêtre flash mappée (optionnelle) : active spi-mem dirmap */
+	res = platform_get_resource_byname(pdev, IORESOURCE_MEM, "dirmap");
+	if (res && is_power_of_2(resource_size(res)) &&
+	    resource_size(res) >= SZ_128K && resource_size(res) <= SZ_16M) {
+		rsd->mmap = devm_ioremap_resource(&pdev->dev, res);
+		if (IS_ERR(rsd->mmap)) {
+			dev_warn(&pdev->dev, "flash window unavailable, PIO reads only\n");
+			rsd->mmap = NULL;
+		} else {
+			rsd->mmap_size = resource_size(res);
+			master->mem_ops = &realtek_spi_mem_ops;
+		}
+	}
+
 	/* Horloge (optionnelle) */
 	rsd->clk = devm_clk_get(&pdev->dev, NULL);
 	if (!IS_ERR(rsd->clk)) {
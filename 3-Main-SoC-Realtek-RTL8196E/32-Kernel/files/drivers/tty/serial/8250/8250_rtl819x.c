@@ -11,6 +11,15 @@
  * sufficient on this SoC. Also forces registration as ttyS1 to avoid stealing
  * the console (ttyS0) from UART0.
  *
+ * RX latency: the FIFO is only 16 bytes deep, so at 460800 baud a trigger
+ * level of 8 leaves ~170 us before overrun. The trigger level can be set
+ * from DT ("rx-trigger-bytes") or at runtime through the 8250 core
+ * attribute /sys/class/tty/ttyS1/rx_trig_bytes. An optional hrtimer
+ * ("rx-drain-us", or the rx_drain_us attribute of the platform device)
+ * empties the FIFO between interrupts, and rx_stats reports how long each
+ * RX service took from entry to tty_flip_buffer_push() plus the worst gap
+ * between two services.
+ *
  * Copyright (C) 2025 Jacques Nilo
  */
 
@@ -26,6 +35,10 @@
 #include <linux/of_irq.h>
 #include <linux/of_platform.h>
 #include <linux/clk.h>
+#include <linux/hrtimer.h>
+#include <linux/ktime.h>
+
+#include <asm/mach-realtek/realtek_irq.h>
 
 #include "8250.h"
 
@@ -41,18 +54,51 @@
 #define RTL8196E_UART_FLOW_CTRL_REG_PHYS	0x18002110
 #define RTL8196E_UART_FLOW_CTRL_BIT		BIT(29)
 
+/* Allowed range for the periodic RX drain (us) */
+#define RTL8196E_UART_DRAIN_MIN_US		50
+#define RTL8196E_UART_DRAIN_MAX_US		100000
+
+/**
+ * struct rtl8196e_uart_stats - RX service statistics
+ * @irq_rx: RX services done from the UART interrupt
+ * @drain_rx: RX services done from the drain timer
+ * @lat_sum_ns: Sum of entry-to-push latencies
+ * @lat_max_ns: Worst entry-to-push latency
+ * @gap_max_ns: Worst interval between two consecutive RX services
+ * @last: Time of the previous RX service (0 = none since open/reset)
+ *
+ * Only updated from hard interrupt context (UART IRQ or hrtimer), which
+ * never nests on this uniprocessor SoC.
+ */
+struct rtl8196e_uart_stats {
+	u32 irq_rx;
+	u32 drain_rx;
+	u64 lat_sum_ns;
+	u32 lat_max_ns;
+	u64 gap_max_ns;
+	ktime_t last;
+};
+
 /**
  * struct rtl8196e_uart_data - Private data for RTL8196E UART
  * @line: UART line number assigned by serial core
  * @clk: Optional clock for UART
  * @flow_ctrl_base: Virtual address of flow control register
  * @supports_afe: True if auto-flow-control is enabled in DT
+ * @drain_timer: Optional periodic RX FIFO drain
+ * @drain_us: Drain period in microseconds (0 = disabled)
+ * @running: Port is open (drain timer may be armed)
+ * @stats: RX service statistics
  */
 struct rtl8196e_uart_data {
 	int line;
 	struct clk *clk;
 	void __iomem *flow_ctrl_base;
 	bool supports_afe;
+	struct hrtimer drain_timer;
+	u32 drain_us;
+	bool running;
+	struct rtl8196e_uart_stats stats;
 };
 
 /**
@@ -176,6 +222,259 @@ static void rtl8196e_uart_set_termios(struct uart_port *port,
 	}
 }
 
+/**
+ * rtl8196e_uart_account() - Record one RX service
+ * @data: RTL8196E UART private data
+ * @start: Time the service started (IRQ or timer entry)
+ * @drain: True if the service came from the drain timer
+ */
+static void rtl8196e_uart_account(struct rtl8196e_uart_data *data,
+				  ktime_t start, bool drain)
+{
+	struct rtl8196e_uart_stats *st = &data->stats;
+	ktime_t now = ktime_get();
+	u32 lat = (u32)ktime_to_ns(ktime_sub(now, start));
+
+	if (drain)
+		st->drain_rx++;
+	else
+		st->irq_rx++;
+
+	st->lat_sum_ns += lat;
+	if (lat > st->lat_max_ns)
+		st->lat_max_ns = lat;
+
+	if (st->last) {
+		u64 gap = ktime_to_ns(ktime_sub(start, st->last));
+
+		if (gap > st->gap_max_ns)
+			st->gap_max_ns = gap;
+	}
+	st->last = now;
+}
+
+/**
+ * rtl8196e_uart_handle_irq() - UART interrupt handler
+ * @port: UART port
+ *
+ * Same as the 8250 default handler, with timing of the RX services.
+ * serial8250_rx_chars() pushes the flip buffer straight from here; the
+ * only remaining hop to the line discipline is the tty core flush work.
+ *
+ * Return: 1 if the interrupt was ours, 0 otherwise
+ */
+static int rtl8196e_uart_handle_irq(struct uart_port *port)
+{
+	struct rtl8196e_uart_data *data = port->private_data;
+	ktime_t start;
+	unsigned int iir;
+	int handled;
+
+	rtl819x_irq_latency_mark(port->irq);
+	start = ktime_get();
+	iir = serial_port_in(port, UART_IIR);
+
+	handled = serial8250_handle_irq(port, iir);
+
+	switch (iir & 0x0f) {
+	case UART_IIR_RDI:
+	case UART_IIR_RX_TIMEOUT:
+	case UART_IIR_RLSI:
+		rtl8196e_uart_account(data, start, false);
+		break;
+	}
+
+	return handled;
+}
+
+/**
+ * rtl8196e_uart_drain() - Drain timer callback
+ * @timer: drain_timer of the port
+ *
+ * Empties the RX FIFO without waiting for the trigger level or the
+ * character timeout, for baud rates where the IRQ alone arrives too late.
+ *
+ * Return: HRTIMER_RESTART while drain_us is non-zero
+ */
+static enum hrtimer_restart rtl8196e_uart_drain(struct hrtimer *timer)
+{
+	struct rtl8196e_uart_data *data =
+		container_of(timer, struct rtl8196e_uart_data, drain_timer);
+	struct uart_8250_port *up = serial8250_get_port(data->line);
+	struct uart_port *port = &up->port;
+	ktime_t start = ktime_get();
+	unsigned long flags;
+	unsigned char lsr;
+	bool rx = false;
+
+	spin_lock_irqsave(&port->lock, flags);
+	lsr = serial_port_in(port, UART_LSR);
+	if (lsr & (UART_LSR_DR | UART_LSR_BI)) {
+		serial8250_rx_chars(up, lsr);
+		rx = true;
+	}
+	spin_unlock_irqrestore(&port->lock, flags);
+
+	if (rx)
+		rtl8196e_uart_account(data, start, true);
+
+	if (!data->drain_us)
+		return HRTIMER_NORESTART;
+
+	hrtimer_forward_now(timer, us_to_ktime(data->drain_us));
+	return HRTIMER_RESTART;
+}
+
+static void rtl8196e_uart_drain_start(struct rtl8196e_uart_data *data)
+{
+	if (!data->drain_us || !data->running)
+		return;
+
+	hrtimer_start(&data->drain_timer, us_to_ktime(data->drain_us),
+		      HRTIMER_MODE_REL);
+}
+
+/**
+ * rtl8196e_uart_startup() - Port open
+ * @port: UART port
+ *
+ * Return: 0 on success, negative error code on failure
+ */
+static int rtl8196e_uart_startup(struct uart_port *port)
+{
+	struct rtl8196e_uart_data *data = port->private_data;
+	int ret;
+
+	ret = serial8250_do_startup(port);
+	if (ret)
+		return ret;
+
+	memset(&data->stats, 0, sizeof(data->stats));
+	data->running = true;
+	rtl8196e_uart_drain_start(data);
+
+	return 0;
+}
+
+/**
+ * rtl8196e_uart_shutdown() - Port close
+ * @port: UART port
+ */
+static void rtl8196e_uart_shutdown(struct uart_port *port)
+{
+	struct rtl8196e_uart_data *data = port->private_data;
+
+	data->running = false;
+	hrtimer_cancel(&data->drain_timer);
+
+	serial8250_do_shutdown(port);
+}
+
+/**
+ * rtl8196e_uart_rx_trig() - Map an RX trigger level to FCR bits
+ * @bytes: Requested level in bytes
+ *
+ * Rounds down to the nearest 16550A level (1, 4, 8 or 14 bytes).
+ *
+ * Return: UART_FCR_R_TRIG_* value
+ */
+static unsigned char rtl8196e_uart_rx_trig(u32 bytes)
+{
+	if (bytes >= 14)
+		return UART_FCR_R_TRIG_11;
+	if (bytes >= 8)
+		return UART_FCR_R_TRIG_10;
+	if (bytes >= 4)
+		return UART_FCR_R_TRIG_01;
+	return UART_FCR_R_TRIG_00;
+}
+
+/* sysfs: /sys/devices/platform/.../rx_drain_us */
+static ssize_t rx_drain_us_show(struct device *dev,
+				struct device_attribute *attr, char *buf)
+{
+	struct rtl8196e_uart_data *data = dev_get_drvdata(dev);
+
+	return sprintf(buf, "%u\n", data->drain_us);
+}
+
+static ssize_t rx_drain_us_store(struct device *dev,
+				 struct device_attribute *attr,
+				 const char *buf, size_t count)
+{
+	struct rtl8196e_uart_data *data = dev_get_drvdata(dev);
+	u32 val;
+	int ret;
+
+	ret = kstrtou32(buf, 0, &val);
+	if (ret)
+		return ret;
+	if (val && (val < RTL8196E_UART_DRAIN_MIN_US ||
+		    val > RTL8196E_UART_DRAIN_MAX_US))
+		return -EINVAL;
+
+	hrtimer_cancel(&data->drain_timer);
+	data->drain_us = val;
+	rtl8196e_uart_drain_start(data);
+
+	return count;
+}
+static DEVICE_ATTR_RW(rx_drain_us);
+
+/* sysfs: /sys/devices/platform/.../rx_stats (write anything to reset) */
+static ssize_t rx_stats_show(struct device *dev,
+			     struct device_attribute *attr, char *buf)
+{
+	struct rtl8196e_uart_data *data = dev_get_drvdata(dev);
+	struct uart_8250_port *up = serial8250_get_port(data->line);
+	struct rtl8196e_uart_stats st;
+	unsigned long flags;
+	u32 n;
+
+	local_irq_save(flags);
+	st = data->stats;
+	local_irq_restore(flags);
+
+	n = st.irq_rx + st.drain_rx;
+
+	return sprintf(buf,
+		       "irq_rx: %u\n"
+		       "drain_rx: %u\n"
+		       "push_latency_avg_ns: %llu\n"
+		       "push_latency_max_ns: %u\n"
+		       "service_gap_max_us: %llu\n"
+		       "rx_trig_fcr: 0x%02x\n"
+		       "overrun: %u\n",
+		       st.irq_rx, st.drain_rx,
+		       n ? div_u64(st.lat_sum_ns, n) : 0ULL,
+		       st.lat_max_ns,
+		       div_u64(st.gap_max_ns, NSEC_PER_USEC),
+		       up->fcr & UART_FCR_TRIGGER_MASK,
+		       up->port.icount.overrun);
+}
+
+static ssize_t rx_stats_store(struct device *dev,
+			      struct device_attribute *attr,
+			      const char *buf, size_t count)
+{
+	struct rtl8196e_uart_data *data = dev_get_drvdata(dev);
+	unsigned long flags;
+
+	local_irq_save(flags);
+	memset(&data->stats, 0, sizeof(data->stats));
+	local_irq_restore(flags);
+
+	return count;
+}
+static DEVICE_ATTR_RW(rx_stats);
+
+static struct attribute *rtl8196e_uart_attrs[] = {
+	&dev_attr_rx_drain_us.attr,
+	&dev_attr_rx_stats.attr,
+	NULL,
+};
+ATTRIBUTE_GROUPS(rtl8196e_uart);
+
 /**
  * rtl8196e_uart_probe() - Probe and initialize RTL8196E UART
  * @pdev: Platform device
@@ -188,7 +487,9 @@ static int rtl8196e_uart_probe(struct platform_device *pdev)
 {
 	struct uart_8250_port uart = {};
 	struct rtl8196e_uart_data *data;
+	struct uart_8250_port *up;
 	struct resource *regs;
+	u32 rx_trig = 8;
 	int ret;
 
 	data = devm_kzalloc(&pdev->dev, sizeof(*data), GFP_KERNEL);
@@ -233,6 +534,25 @@ static int rtl8196e_uart_probe(struct platform_device *pdev)
 	/* Install custom set_termios handler for dynamic flow control */
 	uart.port.set_termios = rtl8196e_uart_set_termios;
 
+	/* Timed IRQ handler, open/close hooks for the drain timer */
+	uart.port.handle_irq = rtl8196e_uart_handle_irq;
+	uart.port.startup = rtl8196e_uart_startup;
+	uart.port.shutdown = rtl8196e_uart_shutdown;
+
+	hrtimer_init(&data->drain_timer, CLOCK_MONOTONIC, HRTIMER_MODE_REL);
+	data->drain_timer.function = rtl8196e_uart_drain;
+	of_property_read_u32(pdev->dev.of_node, "rx-drain-us", &data->drain_us);
+	if (data->drain_us && (data->drain_us < RTL8196E_UART_DRAIN_MIN_US ||
+			       data->drain_us > RTL8196E_UART_DRAIN_MAX_US)) {
+		dev_warn(&pdev->dev, "rx-drain-us %u out of range, disabled\n",
+			 data->drain_us);
+		data->drain_us = 0;
+	}
+	if (data->drain_us && hrtimer_resolution > data->drain_us * NSEC_PER_USEC)
+		dev_warn(&pdev->dev,
+			 "rx-drain-us %u below timer resolution (%u ns)\n",
+			 data->drain_us, hrtimer_resolution);
+
 	/* Get IRQ from device tree */
 	uart.port.irq = platform_get_irq(pdev, 0);
 	if (uart.port.irq < 0) {
@@ -275,7 +595,8 @@ static int rtl8196e_uart_probe(struct platform_device *pdev)
 	/* Configure FIFO */
 	uart.port.fifosize = 16;
 	uart.tx_loadsz = 16;
-	uart.fcr = UART_FCR_ENABLE_FIFO | UART_FCR_R_TRIG_10;
+	of_property_read_u32(pdev->dev.of_node, "rx-trigger-bytes", &rx_trig);
+	uart.fcr = UART_FCR_ENABLE_FIFO | rtl8196e_uart_rx_trig(rx_trig);
 
 	/* Set port flags */
 	uart.port.flags = UPF_FIXED_PORT | UPF_FIXED_TYPE | UPF_BOOT_AUTOCONF;
@@ -293,6 +614,14 @@ static int rtl8196e_uart_probe(struct platform_device *pdev)
 	data->line = ret;
 	platform_set_drvdata(pdev, data);
 
+	/*
+	 * The 8250 core resets fcr to the PORT_16550A default when it
+	 * configures the port; re-apply the DT trigger level. Later changes
+	 * go through /sys/class/tty/ttyS1/rx_trig_bytes.
+	 */
+	up = serial8250_get_port(data->line);
+	up->fcr = (up->fcr & ~UART_FCR_TRIGGER_MASK) | rtl8196e_uart_rx_trig(rx_trig);
+
 	return 0;
 
 err_clk_disable:
@@ -312,6 +641,7 @@ static int rtl8196e_uart_remove(struct platform_device *pdev)
 	struct rtl8196e_uart_data *data = platform_get_drvdata(pdev);
 
 	serial8250_unregister_port(data->line);
+	hrtimer_cancel(&data->drain_timer);
 
 	if (!IS_ERR(data->clk))
 		clk_disable_unprepare(data->clk);
@@ -333,6 +663,7 @@ static struct platform_driver rtl8196e_uart_driver = {
 	.driver = {
 		.name = "rtl8196e-uart",
 		.of_match_table = rtl8196e_uart_of_match,
+		.dev_groups = rtl8196e_uart_groups,
 	},
 };
 
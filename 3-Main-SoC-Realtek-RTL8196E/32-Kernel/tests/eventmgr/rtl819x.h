@@ -0,0 +1,31 @@
+/*
+ * Host shim standing in for the driver's include/rtl819x.h when
+ * common/rtl865x_eventMgr.c is built by bench_eventmgr: only the types,
+ * return codes and kernel calls the event manager uses.
+ *
+ * J. Nilo - December 2025
+ */
+#ifndef RTL819X_HOST_SHIM_H
+#define RTL819X_HOST_SHIM_H
+
+#include <stdio.h>
+#include <string.h>
+
+typedef unsigned int uint32;
+typedef int int32;
+typedef unsigned short uint16;
+typedef unsigned char uint8;
+
+#define SUCCESS			0
+#define FAILED			-1
+#define TRUE			1
+#define FALSE			0
+
+#define RTL_EENTRYALREADYEXIST	-2
+#define RTL_EENTRYNOTFOUND	-3
+#define RTL_EINVALIDINPUT	-6
+#define RTL_ENOFREEBUFFER	-9
+
+#define printk			printf
+
+#endif
@@ -4,6 +4,7 @@
 # This script:
 #   - Creates a SquashFS image from skeleton/ directory
 #   - Adds device nodes (console, null, zero)
+#   - Orders files by boot access if squashfs_sort.sh was run
 #   - Converts to RTL bootloader format with cvimg
 #
 # Output: rootfs.bin (ready to flash)
@@ -45,10 +46,19 @@ mkdir -p skeleton/dev
 # Clean old images
 rm -f rootfs.sqfs rootfs.bin
 
+# Boot access layout from squashfs_sort.sh (optional)
+SQUASHFS_BLOCK=256k
+SORT_OPT=""
+if [ -f rootfs.sort ]; then
+    [ -f rootfs.layout ] && . ./rootfs.layout
+    SORT_OPT="-sort rootfs.sort"
+    echo "📑 Boot access order from rootfs.sort, block size ${SQUASHFS_BLOCK}"
+fi
+
 echo "📦 Generating SquashFS with device nodes..."
 fakeroot mksquashfs skeleton rootfs.sqfs \
   -nopad -noappend -all-root \
-  -comp xz -b 256k \
+  -comp xz -b ${SQUASHFS_BLOCK} ${SORT_OPT} \
   -p "/dev/console c 600 0 0 5 1" \
   -p "/dev/null c 666 0 0 1 3" \
   -p "/dev/zero c 666 0 0 1 5"
@@ -0,0 +1,198 @@
+#!/bin/bash
+# squashfs_sort.sh — Lay out the rootfs SquashFS in boot-time access order
+#
+# Usage:
+#   ./squashfs_sort.sh <gateway_ip>                # fetch the trace over SSH
+#   ./squashfs_sort.sh <boot_access.log>
+#   sudo ./squashfs_sort.sh <...> --measure        # compare layouts too
+#
+# Record the trace on the gateway first:
+#   touch /userdata/etc/boot_trace && reboot
+# rcS then runs inotifyd until the userdata init scripts are done and
+# leaves /var/log/boot_access.log. Remove /userdata/etc/boot_trace after.
+#
+# Writes rootfs.sort (mksquashfs -sort: files opened at boot first, in
+# opening order) and rootfs.layout (block size), both picked up by
+# build_rootfs.sh. Delete them to go back to the default layout.
+#
+# With --measure, each candidate block size is built with the options of
+# build_rootfs.sh, loop-mounted read-only and the trace replayed from a
+# cold cache. The KiB and requests read from the loop device stand for
+# the XZ blocks decompressed at boot. The layout reading the least that
+# still fits the rootfs partition is kept; without --measure the block
+# size stays at the build_rootfs.sh default.
+#
+# Time to userspace is measured on the gateway: compare rcS.start in the
+# 32-Kernel/boot_timeline.sh output before and after reflashing.
+#
+# J. Nilo - December 2025
+
+set -e
+
+SCRIPT_DIR="$(cd "$(dirname "$0")" && pwd)"
+SKELETON_DIR="${SCRIPT_DIR}/skeleton"
+SORT_FILE="${SCRIPT_DIR}/rootfs.sort"
+LAYOUT_FILE="${SCRIPT_DIR}/rootfs.layout"
+PARTITION_SIZE=$((0x200000))	# mtd2, see rtl8196e.dts
+BLOCK_SIZES="64k 128k 256k"
+DEFAULT_BLOCK=256k
+SSH_PORT=22
+SSH_USER="root"
+
+SOURCE=""
+MEASURE=0
+for arg in "$@"; do
+    case $arg in
+        --measure) MEASURE=1 ;;
+        --help|-h)
+            sed -n '2,26p' "$0" | sed 's/^# \{0,1\}//'
+            exit 0
+            ;;
+        *) SOURCE="$arg" ;;
+    esac
+done
+
+if [ -z "$SOURCE" ]; then
+    echo "Usage: $0 <gateway_ip | boot_access.log> [--measure]"
+    exit 1
+fi
+
+for tool in fakeroot mksquashfs; do
+    if ! command -v $tool >/dev/null 2>&1; then
+        echo "❌ $tool is not installed"
+        echo "   Installation: sudo apt-get install fakeroot squashfs-tools"
+        exit 1
+    fi
+done
+
+if [ "$MEASURE" -eq 1 ] && [ "$(id -u)" -ne 0 ]; then
+    echo "❌ --measure must run as root (losetup, mount, drop_caches)"
+    exit 1
+fi
+
+TMP=$(mktemp -d)
+MNT="${TMP}/mnt"
+mkdir -p "$MNT"
+trap 'umount "$MNT" 2>/dev/null || true; rm -rf "$TMP"' EXIT
+
+if [ -f "$SOURCE" ]; then
+    cp "$SOURCE" "$TMP/trace"
+else
+    ssh -p "$SSH_PORT" ${SSH_USER}@"$SOURCE" "cat /var/log/boot_access.log" > "$TMP/trace"
+fi
+
+echo "========================================="
+echo "  SQUASHFS BOOT LAYOUT"
+echo "========================================="
+echo ""
+
+# inotifyd lines: "<events>\t<watched dir>\t<name>". Files opened before
+# the trace starts (init, inittab, rcS, mount, ...) all come from these.
+{
+    printf 'r\t/bin\tbusybox\nr\t/etc\tinittab\nr\t/etc/init.d\trcS\n'
+    cat "$TMP/trace"
+} | awk -F'\t' '
+    NF >= 3 && $3 != "" {
+        p = $2 "/" $3; sub(/^\/+/, "", p)
+        if (!(p in seen)) { seen[p] = 1; print p }
+    }' > "$TMP/opened"
+
+# Keep regular files of the image only (symlinks may point to /userdata)
+: > "$TMP/order"
+while read -r p; do
+    if [ -f "${SKELETON_DIR}/$p" ] && [ ! -L "${SKELETON_DIR}/$p" ]; then
+        echo "$p" >> "$TMP/order"
+    fi
+done < "$TMP/opened"
+
+if [ ! -s "$TMP/order" ]; then
+    echo "❌ No rootfs file found in the trace"
+    exit 1
+fi
+
+echo "Boot access order ($(wc -l < "$TMP/order") files):"
+sed 's/^/  /' "$TMP/order"
+echo ""
+
+# Highest priority is written first
+awk '{ print $0, 32767 - NR + 1 }' "$TMP/order" > "$TMP/rootfs.sort"
+
+# build_image <output> <block size> [sort file]
+# Same options and device nodes as build_rootfs.sh
+build_image() {
+    fakeroot mksquashfs "$SKELETON_DIR" "$1" \
+      -nopad -noappend -all-root \
+      -comp xz -b "$2" ${3:+-sort "$3"} \
+      -p "/dev/console c 600 0 0 5 1" \
+      -p "/dev/null c 666 0 0 1 3" \
+      -p "/dev/zero c 666 0 0 1 5" > /dev/null
+}
+
+# replay <image> -> "read_kib read_requests ms"
+replay() {
+    local loop dev r0 s0 r1 s1 t0 t1 x
+
+    loop=$(losetup -f --show -r "$1")
+    dev=${loop##*/}
+    mount -t squashfs -o ro "$loop" "$MNT"
+    sync
+    echo 3 > /proc/sys/vm/drop_caches
+
+    read -r r0 x s0 x < "/sys/block/${dev}/stat"
+    t0=$(date +%s%N)
+    while read -r p; do
+        cat "${MNT}/$p" > /dev/null
+    done < "$TMP/order"
+    t1=$(date +%s%N)
+    read -r r1 x s1 x < "/sys/block/${dev}/stat"
+
+    umount "$MNT"
+    losetup -d "$loop"
+    echo "$(((s1 - s0) / 2)) $((r1 - r0)) $(((t1 - t0) / 1000000))"
+}
+
+LAYOUTS="${DEFAULT_BLOCK}:none"
+for b in $BLOCK_SIZES; do
+    LAYOUTS="$LAYOUTS ${b}:sorted"
+done
+
+BEST_BLOCK=$DEFAULT_BLOCK
+BEST_KIB=""
+printf "%-14s %10s %5s" "layout" "size (KiB)" "fits"
+[ "$MEASURE" -eq 1 ] && printf " %10s %9s %8s" "read (KiB)" "requests" "ms"
+echo ""
+
+for l in $LAYOUTS; do
+    b=${l%%:*}
+    img="${TMP}/${b}.${l##*:}.sqfs"
+    if [ "${l##*:}" = "sorted" ]; then
+        build_image "$img" "$b" "$TMP/rootfs.sort"
+    else
+        build_image "$img" "$b"
+    fi
+
+    size=$(stat -c %s "$img")
+    fits=yes
+    [ "$size" -gt "$PARTITION_SIZE" ] && fits=no
+    printf "%-14s %10d %5s" "$b ${l##*:}" $((size / 1024)) "$fits"
+
+    if [ "$MEASURE" -eq 1 ]; then
+        read -r kib req ms <<< "$(replay "$img")"
+        printf " %10d %9d %8d" "$kib" "$req" "$ms"
+        if [ "${l##*:}" = "sorted" ] && [ "$fits" = yes ] &&
+           { [ -z "$BEST_KIB" ] || [ "$kib" -lt "$BEST_KIB" ]; }; then
+            BEST_KIB=$kib
+            BEST_BLOCK=$b
+        fi
+    fi
+    echo ""
+done
+
+cp "$TMP/rootfs.sort" "$SORT_FILE"
+echo "SQUASHFS_BLOCK=${BEST_BLOCK}" > "$LAYOUT_FILE"
+
+echo ""
+echo "✅ rootfs.sort and rootfs.layout written (block size ${BEST_BLOCK})"
+echo ""
+echo "Next: ./build_rootfs.sh && ./flash_rootfs.sh, then compare rcS.start"
+echo "      with ../32-Kernel/boot_timeline.sh <gateway_ip>"
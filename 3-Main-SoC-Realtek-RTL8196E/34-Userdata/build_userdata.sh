@@ -4,6 +4,7 @@
 # This script:
 #   - Builds nano editor + serialgateway
 #   - Creates JFFS2 filesystem from skeleton/ directory
+#   - Adds erase-block summaries with sumtool (CONFIG_JFFS2_SUMMARY)
 #   - Converts to RTL bootloader format with cvimg
 #
 # Usage:
@@ -68,6 +69,13 @@ if ! command -v fakeroot >/dev/null 2>&1; then
     exit 1
 fi
 
+# Check that sumtool is installed (same package as mkfs.jffs2)
+if ! command -v sumtool >/dev/null 2>&1; then
+    echo "sumtool is not installed"
+    echo "   Installation: sudo apt-get install mtd-utils"
+    exit 1
+fi
+
 # Check that cvimg is built
 BUILD_ENV="${PROJECT_ROOT}/../1-Build-Environment/11-realtek-tools"
 CVIMG_TOOL="${BUILD_ENV}/bin/cvimg"
@@ -146,18 +154,29 @@ ERASEBLOCK_HEX=0x10000
 PARTITION_SIZE_HEX=0xC00000
 JFFS2_PAD_HEX=$((PARTITION_SIZE_HEX - 2))
 
-echo "Generating JFFS2 (big endian, 64KB eraseblocks, zlib, padded to ${JFFS2_PAD_HEX} bytes)..."
+echo "Generating JFFS2 (big endian, 64KB eraseblocks, zlib)..."
 # Force zlib-only compression - requires CONFIG_JFFS2_ZLIB=y in kernel
 fakeroot mkfs.jffs2 \
   -r "$SKELETON_DIR" \
-  -o "${SCRIPT_DIR}/userdata.jffs2" \
+  -o "${SCRIPT_DIR}/userdata.raw.jffs2" \
   -e ${ERASEBLOCK_HEX} \
   -b \
   -n \
   --squash \
-  --pad=${JFFS2_PAD_HEX} \
   -X zlib
 
+# Append a summary node to each erase block so the kernel mounts from the
+# summaries instead of scanning every node (requires CONFIG_JFFS2_SUMMARY=y).
+# sumtool re-lays the nodes out, so padding is done here rather than by mkfs.
+echo "Adding erase-block summaries (padded to ${JFFS2_PAD_HEX} bytes)..."
+sumtool \
+  -i "${SCRIPT_DIR}/userdata.raw.jffs2" \
+  -o "${SCRIPT_DIR}/userdata.jffs2" \
+  -e ${ERASEBLOCK_HEX} \
+  -b \
+  -n \
+  --pad=${JFFS2_PAD_HEX}
+
 echo "JFFS2 image created"
 echo ""
 
@@ -170,8 +189,8 @@ $CVIMG_TOOL \
     -b 0x400000 \
     -s r6cr
 
-# Remove intermediate file
-rm -f userdata.jffs2
+# Remove intermediate files
+rm -f userdata.raw.jffs2 userdata.jffs2
 
 echo ""
 echo "========================================="
@@ -0,0 +1,167 @@
+#!/bin/bash
+# jffs2_mount_bench.sh — Compare JFFS2 mount with and without summaries
+#
+# Runs on a Linux host (root required). Builds the userdata image twice
+# from skeleton/, once as before (mkfs.jffs2 only) and once with the
+# sumtool pass of build_userdata.sh, writes each to an mtdram device with
+# the same size and erase block as the gateway partition, then reports the
+# average mount time and the slab memory held by the mounted filesystem.
+#
+# mtdram is used rather than nandsim: the gateway has SPI NOR, which has
+# no OOB area and no cleanmarkers in it, like mtdram.
+#
+# Images are built in host byte order (JFFS2 cannot mount a foreign-endian
+# image); node layout and counts are otherwise those of the gateway image.
+#
+# Usage:
+#   sudo ./jffs2_mount_bench.sh [--fill MB] [--runs N]
+#
+#   --fill MB   Add MB of incompressible files, like a userdata partition
+#               after some use (default: 4)
+#   --runs N    Mounts per image, results averaged (default: 10)
+#
+# Requires: mtd-utils (mkfs.jffs2, sumtool, flashcp), host kernel with
+# mtdram module and CONFIG_JFFS2_FS + CONFIG_JFFS2_SUMMARY.
+#
+# J. Nilo - December 2025
+
+set -e
+
+SCRIPT_DIR="$(cd "$(dirname "$0")" && pwd)"
+SKELETON_DIR="${SCRIPT_DIR}/skeleton"
+
+# Same geometry as build_userdata.sh (mtd3, 12MB, 64KB erase blocks)
+ERASEBLOCK_HEX=0x10000
+PARTITION_SIZE_HEX=0xC00000
+FILL_MB=4
+RUNS=10
+
+while [ $# -gt 0 ]; do
+    case $1 in
+        --fill) FILL_MB="$2"; shift 2 ;;
+        --runs) RUNS="$2"; shift 2 ;;
+        --help|-h)
+            sed -n '2,24p' "$0" | sed 's/^# \{0,1\}//'
+            exit 0
+            ;;
+        *)
+            echo "Unknown option: $1"
+            echo "Use --help for usage information"
+            exit 1
+            ;;
+    esac
+done
+
+if [ "$(id -u)" -ne 0 ]; then
+    echo "Must run as root (modprobe, mount)"
+    exit 1
+fi
+
+for tool in mkfs.jffs2 sumtool flashcp; do
+    if ! command -v $tool >/dev/null 2>&1; then
+        echo "$tool is not installed"
+        echo "   Installation: sudo apt-get install mtd-utils"
+        exit 1
+    fi
+done
+
+KCONFIG="/boot/config-$(uname -r)"
+if [ -f "$KCONFIG" ] && ! grep -q "^CONFIG_JFFS2_SUMMARY=y" "$KCONFIG"; then
+    echo "Warning: host kernel built without CONFIG_JFFS2_SUMMARY,"
+    echo "         both images will be scanned the same way"
+    echo ""
+fi
+
+# Host byte order
+if [ "$(printf '\1\0' | od -An -tu2 | tr -d ' ')" = "1" ]; then
+    ENDIAN=-l
+else
+    ENDIAN=-b
+fi
+
+TMP=$(mktemp -d)
+MNT="${TMP}/mnt"
+mkdir -p "$MNT" "${TMP}/root"
+
+cleanup() {
+    umount "$MNT" 2>/dev/null || true
+    rmmod mtdram 2>/dev/null || true
+    rm -rf "$TMP"
+}
+trap cleanup EXIT
+
+echo "========================================="
+echo "  JFFS2 SUMMARY MOUNT TEST"
+echo "========================================="
+echo ""
+
+# Source tree: skeleton + incompressible filler
+cp -a "${SKELETON_DIR}/." "${TMP}/root/"
+if [ "$FILL_MB" -gt 0 ]; then
+    mkdir -p "${TMP}/root/fill"
+    for i in $(seq 1 $((FILL_MB * 4))); do
+        head -c 262144 /dev/urandom > "${TMP}/root/fill/f$i"
+    done
+fi
+echo "Source: skeleton + ${FILL_MB} MB filler ($(find "${TMP}/root" | wc -l) entries)"
+
+# Same options as build_userdata.sh
+mkfs.jffs2 -r "${TMP}/root" -o "${TMP}/plain.jffs2" \
+    -e ${ERASEBLOCK_HEX} $ENDIAN -n --squash -X zlib \
+    --pad=$((PARTITION_SIZE_HEX))
+mkfs.jffs2 -r "${TMP}/root" -o "${TMP}/raw.jffs2" \
+    -e ${ERASEBLOCK_HEX} $ENDIAN -n --squash -X zlib
+sumtool -i "${TMP}/raw.jffs2" -o "${TMP}/summary.jffs2" \
+    -e ${ERASEBLOCK_HEX} $ENDIAN -n --pad=$((PARTITION_SIZE_HEX))
+
+modprobe mtdram total_size=$((PARTITION_SIZE_HEX / 1024)) \
+    erase_size=$((ERASEBLOCK_HEX / 1024))
+MTD=$(awk -F: '/mtdram test device/ { print $1 }' /proc/mtd)
+if [ -z "$MTD" ]; then
+    echo "mtdram device not found in /proc/mtd"
+    exit 1
+fi
+
+slab_kb() {
+    awk '/^Slab:/ { print $2 }' /proc/meminfo
+}
+
+# measure <image> -> "avg_ms slab_kb"
+measure() {
+    local t0 t1 total=0 s0 s1 slab=0 i
+
+    flashcp "$1" "/dev/${MTD}"
+    for i in $(seq 1 "$RUNS"); do
+        sync
+        echo 3 > /proc/sys/vm/drop_caches
+        s0=$(slab_kb)
+        t0=$(date +%s%N)
+        mount -t jffs2 -o ro "$MTD" "$MNT"
+        t1=$(date +%s%N)
+        s1=$(slab_kb)
+        umount "$MNT"
+        total=$((total + t1 - t0))
+        slab=$((slab + s1 - s0))
+    done
+    echo "$((total / RUNS / 1000)) $((slab / RUNS))"
+}
+
+echo "Mounting each image ${RUNS} times on /dev/${MTD}..."
+read -r PLAIN_US PLAIN_KB <<< "$(measure "${TMP}/plain.jffs2")"
+read -r SUM_US SUM_KB <<< "$(measure "${TMP}/summary.jffs2")"
+
+echo ""
+printf "%-12s %14s %14s\n" "image" "mount (ms)" "slab (kB)"
+printf "%-12s %14s %14s\n" "plain" \
+    "$(awk -v v="$PLAIN_US" 'BEGIN { printf "%.2f", v / 1000 }')" "$PLAIN_KB"
+printf "%-12s %14s %14s\n" "summary" \
+    "$(awk -v v="$SUM_US" 'BEGIN { printf "%.2f", v / 1000 }')" "$SUM_KB"
+echo ""
+awk -v p="$PLAIN_US" -v s="$SUM_US" -v pk="$PLAIN_KB" -v sk="$SUM_KB" 'BEGIN {
+    if (p > 0)
+        printf "Mount time: %.0f%% of plain\n", s * 100 / p
+    printf "Slab: %+d kB with summaries\n", sk - pk
+}'
+echo ""
+echo "Host CPU and mtdram (RAM-backed) only give the ratio: on the gateway"
+echo "the scan also reads every node over SPI, so the absolute gain is larger."